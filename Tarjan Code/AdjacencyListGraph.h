@@ -14,6 +14,7 @@
 #include <unordered_map>
 #include "utilities.hpp"
 #include <random>       // std::default_random_engine
+#include <algorithm>
 #include "simpleClock.h"
 
 template <class V>
@@ -154,15 +155,15 @@ void AdjacencyListGraph<V>::removeVertex(V vertex){
 template<class V>
 void AdjacencyListGraph<V>::removeEdge(V from, V to){
     
-    std::vector<V>& vect(edges[from]);
+    auto entry = edges.find(from);
     
-    auto it = vect.begin();
+    if(entry == edges.end()) //Do not create the vertex just to remove an edge from it
+        return;
     
-    while(it != vect.end()){
-        if(*it == to)
-            it = vect.erase(it);
-
-    }
+    std::vector<V>& vect(entry->second);
+    
+    //Removes every copy of the edge
+    vect.erase(std::remove(vect.begin(), vect.end(), to), vect.end());
 
 }
 
@@ -13,7 +13,6 @@
 #include "dictionary.h"
 #include <mutex>
 #include <unordered_map>
-#include "worker.hpp"
 /**Implements the sychronized dictionary class with sychronized blocks (a mutex)
  */
 
@@ -75,117 +74,6 @@ public:
         
     }
     
-    void putAll(const std::vector<Vid>& vect, Cell<Vid>* cell, Worker& thread){
-        
-       // std::unordered_set<Vid> verts(vect.begin(), vect.end());
-        
-        std::vector<bool>& verts = thread.vAdded; verts.assign(vect.size(), false);
-        int left(verts.size());
-        
-        while(left > 1){
-            
-            for(int v = 0; v < vect.size(); ++v){
-                if(verts[v]) continue;
-                
-                int key = vect[v];
-                Vid key1 = key & (LOCKS - 1);
-                Vid key2 = key >> BITS;
-                thread.spareCell->vertex = key;
-                if(tryLock(key1)){
-                    
-                    auto status = map[key1].insert(std::make_pair(key2, WeakReference<Cell<Vid>>(thread.spareCell, thread.spareCell->age)));
-                    unlock(key1);
-                    
-                    verts[v] = true; left--;
-                    
-                    if(status.second)
-                        thread.allocateSpareCell();
-
-                    
-                    Cell<Vid>* neighbor = (status.first)->second.get();
-                    int age = (status.first)->second.age;
-                    
-                    
-                    if(!neighbor->isComplete(age)) //If the neighbor is complete, no search has to visit it again
-                        cell->addNeighbor(neighbor, age);
-                    
-                    
-                }
-            
-            }
-        }
-        
-        for(int v = 0; v < vect.size(); ++v){
-            if(verts[v]) continue;
-        
-            int key = vect[v];
-        
-            Vid key1 = key & (LOCKS - 1);
-            Vid key2 = key >> BITS;
-            thread.spareCell->vertex = key;
-            
-            lock(key1);
-            
-            auto status =  map[key1].insert(std::make_pair(key2,  WeakReference<Cell<Vid>>(thread.spareCell, thread.spareCell->age)));
-            
-            unlock(key1);
-            
-                if(status.second)
-                    thread.allocateSpareCell();
-                
-                Cell<Vid>* neighbor = (status.first)->second.get();
-                int age = (status.first)->second.age;
-                
-                
-                if(!neighbor->isComplete(age)) //If the neighbor is complete, no search has to visit it again
-                    cell->addNeighbor(neighbor, age);
-                
-            return;
-        }
-        
-
-        
-        /*
-        while(verts.size() > 0){
-            
-            auto it = verts.begin();
-            while(it != verts.end()){
-                int key = *it;
-                Vid key1 = key & (LOCKS - 1);
-                Vid key2 = key >> BITS;
-                thread.spareCell->vertex = key;
-                if(tryLock(key1)){
-                    
-                    auto status = map[key1].insert(std::make_pair(key2, WeakReference<Cell<Vid>>(thread.spareCell, thread.spareCell->age)));
-                    unlock(key1);
-                    
-                    if(status.second)
-                        thread.allocateSpareCell();
-                    
-                    it = verts.erase(it);
-                    
-                    Cell<Vid>* neighbor = (status.first)->second.get();
-                    int age = (status.first)->second.age;
-                    
-                    
-                    if(!neighbor->isComplete(age)) //If the neighbor is complete, no search has to visit it again
-                        cell->addNeighbor(neighbor, age);
-                    
-                    break;
-
-                }
-                
-                else it++;
-                    
-            
-            }
-            
-        }*/
-
-        
-    }
-    
-    
     V&    get(const K& key) {
         
         K key1 = key & (LOCKS - 1);
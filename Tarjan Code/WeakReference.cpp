@@ -1,5 +1,5 @@
 //
-//  ReferenceCounter.cpp
+//  WeakReference.cpp
 //  Tarjan4
 //
 //  Created by Alex Zabrodskiy on 6/5/17.
@@ -7,12 +7,7 @@
 //
 
 #include <stdio.h>
-#include "Reference.hpp"
+#include "WeakReference.h"
 #include "cell.h"
 
-template<> void ReferenceCounter<Cell<Vid>>::deleter(){
-    
-    object->recycleThis();
-}
-
 WeakReference<Cell<Vid>> nullWeakReference = WeakReference<Cell<Vid>>(nullptr, 0);
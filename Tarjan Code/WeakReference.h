@@ -10,17 +10,16 @@
 #define WeakReference_h
 
 #include "typedefs.h"
-#include "Reference.hpp"
 
 template <class E>
 struct WeakReference{
     
     E*  subject;
-    Vid age;
+    Age age;
     
     WeakReference() : age(0){}
     
-    WeakReference(E* const  _subject, const Vid _age) : subject(_subject), age(_age){}
+    WeakReference(E* const  _subject, const Age _age) : subject(_subject), age(_age){}
     
     WeakReference( WeakReference<E> && _ref): subject(_ref.subject), age(_ref.age){ }
     WeakReference(const WeakReference<E> & _ref): subject(_ref.subject), age(_ref.age){ }
@@ -41,20 +40,14 @@ struct WeakReference{
         return subject;
     }
     
-    inline Reference<E> getReference();
-    
     //Is the reference expired? In other words, is the object's age greater than when it was when the reference was made
     inline bool isExpired(){
-        return subject->age != age;
+        return subject->getAge() != age;
     }
         
 };
 
-template <class E>
-Reference<E> WeakReference<E>::getReference(){
-        return subject->refCounter.createReference();
-    }
-
+template <class V> struct Cell;
 
 extern WeakReference<Cell<Vid>> nullWeakReference;
 
@@ -0,0 +1,60 @@
+//
+//  alignedArray.h
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/9/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef alignedArray_h
+#define alignedArray_h
+
+#include <stdlib.h>
+#include <new>
+#include <algorithm>
+
+/*Fixed size array of objects declared alignas(64) so that each sits on its own cache line. Before C++17,
+ new[] ignores alignments beyond the allocator's own (16 bytes), which would let neighbours share a line
+ again. The storage comes from posix_memalign instead and the objects are constructed in place*/
+
+template <class T>
+class AlignedArray{
+
+    T* items;
+    size_t count;
+
+public:
+
+    explicit AlignedArray(const size_t _count) : items(nullptr), count(_count){
+        void* memory;
+
+        if(posix_memalign(&memory, std::max(alignof(T), sizeof(void*)), std::max((size_t) 1, count) * sizeof(T)))
+            throw std::bad_alloc();
+
+        items = static_cast<T*>(memory);
+
+        for(size_t i = 0; i < count; ++i)
+            new (items + i) T();
+    }
+
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+
+    ~AlignedArray(){
+        for(size_t i = 0; i < count; ++i)
+            items[i].~T();
+
+        free(items);
+    }
+
+    inline T& operator[](const size_t i) const{
+        return items[i];
+    }
+
+    inline size_t size() const{
+        return count;
+    }
+
+};
+
+#endif /* alignedArray_h */
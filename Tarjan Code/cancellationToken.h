@@ -0,0 +1,73 @@
+//
+//  cancellationToken.h
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/2/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef cancellationToken_h
+#define cancellationToken_h
+
+#include <atomic>
+#include <chrono>
+
+/** A CancellationToken lets the caller of a long SCC computation stop it early. The token can be
+ cancelled explicitly from any thread with cancel(), or it can be given a wall clock budget after
+ which it cancels itself.
+
+ Workers do not read the clock on every edge. Instead they call poll() every few hundred iterations
+ of their main loop; poll() checks the deadline (if there is one) and returns whether the run should stop.
+ Once a token is cancelled it stays cancelled, so a token should not be reused for a second run.
+ */
+
+class CancellationToken{
+
+private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    std::atomic<bool> cancelled;
+    bool hasDeadline;
+    Clock::time_point deadline;
+
+public:
+
+    CancellationToken() : cancelled(false), hasDeadline(false){;}
+
+    //Token that cancels itself once budget has elapsed from the time of construction
+    template <class Rep, class Period>
+    CancellationToken(const std::chrono::duration<Rep, Period>& budget) : cancelled(false), hasDeadline(true),
+    deadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(budget)){;}
+
+    //Restarts the wall clock budget from now. Should be called before the run starts
+    template <class Rep, class Period>
+    void setBudget(const std::chrono::duration<Rep, Period>& budget){
+        deadline    = Clock::now() + std::chrono::duration_cast<Clock::duration>(budget);
+        hasDeadline = true;
+    }
+
+    inline void cancel(){
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    inline bool isCancelled() const{
+        return cancelled.load(std::memory_order_relaxed);
+    }
+
+    //Checks the deadline and returns true if and only if the run should be aborted
+    inline bool poll(){
+        if(cancelled.load(std::memory_order_relaxed))
+            return true;
+
+        if(hasDeadline && Clock::now() >= deadline){
+            cancel(); return true;
+        }
+
+        return false;
+    }
+
+};
+
+
+#endif /* cancellationToken_h */
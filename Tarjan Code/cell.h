@@ -16,58 +16,98 @@
 #include <algorithm>
 #include "search.hpp"
 #include "WeakReference.h"
-#include "Reference.hpp"
 
 template <class V>
 struct Cell;
 
+//Lookahead window of neighbors that were on another search's stack when the cell's cursor passed them
+template <class V>
+struct NeighborWindow{
+    const static int CAPACITY = 8;
+    
+    WeakReference<Cell<V>> entries[CAPACITY];
+    int size = 0;
+    
+    std::vector<V> decoded; //The successors, for graphs with transient spans, see Cell::decodeBuffer()
+};
+
+/* Layout: every discovered vertex gets a cell, so the cell is kept small. With 32 bit vertex ids it is
+ 48 bytes:
+ 
+    age, vertex (8) | status (8) | index, rank (8) | cursor (16) | window (8)
+ 
+ Cells are not reference counted. A completed cell is retired by the worker that completed it and is
+ only reused once every worker has passed a quiescent point, see EpochManager. So a worker can read any
+ cell it resolved since its last quiescent point with plain loads, and only has to compare ages to tell
+ whether the cell still stands for the vertex it looked up.
+ 
+ Very few cells ever have a search blocked on them, so blocked searches are kept in a WaitTable shared by
+ all cells rather than in the cell. The cell only records that it has waiters, in the lowest bit of the
+ age word; the age itself is the rest of the word
+ */
+
 template <class V>
 struct Cell{
     
 private:
     
-    BlockedList<Search*> blockedSearches; //Stores searches blocked on the cell
+    const static Age HAS_WAITERS = 1;
+    
+    std::atomic<Age> age; //Number of times the cell object has been retired, shifted left by one, | HAS_WAITERS
     
 public:
     V           vertex;
-    Vid         index;
-    Vid         rank;
+    
     Status      status;
-    std::vector<WeakReference<Cell<V>>> neighborQueue; //Neighbors to visit
-    ReferenceCounter<Cell<V>>  refCounter;
-    std::atomic<Vid> age;
+    Idx         index;
+    Idx         rank;
+    const V*    nextSucc; //Cursor into the graph's successor list of vertex
+    const V*    lastSucc;
+    NeighborWindow<V>* window; //Occupied neighbors we skipped over, null until first needed
 
-    Cell() : age(0), refCounter(this){ 
+    Cell() : age(0), window(nullptr){ 
     }
 
     
-    ~Cell(){}
+    ~Cell(){
+        delete window;
+    }
     
     /************************************************************************************/
     
-    inline bool isComplete(){
-        return status == CellStatus::COMPLETE_CELL;
+    //Number of times the cell object has been retired
+    inline Age getAge() const{
+        return age.load() >> 1;
+    }
+    
+    //Called by a search about to park in the WaitTable on the cell
+    inline void markWaiters(){
+        age.fetch_or(HAS_WAITERS);
     }
     
-    inline bool isComplete(const Vid expectedAge){
-        return status == CellStatus::COMPLETE_CELL || age != expectedAge;
+    inline bool hasWaiters() const{
+        return age.load() & HAS_WAITERS;
     }
     
-    inline void addNeighbor(Cell<V>* const neighbor, const V succVertex){
-        neighborQueue.emplace_back(neighbor, succVertex);
+    inline bool isComplete(){
+        return status == CellStatus::COMPLETE_CELL;
+    }
+    
+    inline bool isComplete(const Age expectedAge){
+        return status == CellStatus::COMPLETE_CELL || getAge() != expectedAge;
     }
     
     inline bool isNew(){
         return status == CellStatus::NEW_CELL;
     }
     
-    inline bool isNew(const Vid expectedAge){
-        return status == CellStatus::NEW_CELL && age == expectedAge;
+    inline bool isNew(const Age expectedAge){
+        return status == CellStatus::NEW_CELL && getAge() == expectedAge;
     }
     
     static inline bool isUnclaimed(const WeakReference<Cell<V>>& ref){
         
-        return  (ref.get()->status == CellStatus::NEW_CELL) || (ref.get()->status == CellStatus::COMPLETE_CELL) || (ref.get()->age != ref.age);
+        return  (ref.get()->status == CellStatus::NEW_CELL) || (ref.get()->status == CellStatus::COMPLETE_CELL) || (ref.get()->getAge() != ref.age);
 
     }
     
@@ -82,26 +122,11 @@ public:
         status = CellStatus::COMPLETE_CELL;
     }
     
-    inline std::vector<Search*>* removeBlockedList(){
-//        std::lock_guard<std::mutex> lock(blockedOnMutex); //Can prob remove sync if careful
-//        std::vector<Search*>* toReturn(blockedOn);
-//        blockedOn = nullptr;
-//        return toReturn;
-        return 0;
-    }
-    
-    
-    inline BlockedList<Search*>* getBlockedList(){
-        return &blockedSearches;
-        
-    }
-    
-    
-    inline void initIndex(const Vid idx){
+    inline void initIndex(const Idx idx){
         this->index = idx; this->rank = idx;
     }
     
-    inline void promote(Vid rankUpdate){
+    inline void promote(Idx rankUpdate){
         this->rank = std::min(this->rank, rankUpdate);
     }
     
@@ -116,7 +141,7 @@ public:
     
     
     //
-    inline void transfer(const long delta, Search* const newOwner){
+    inline void transfer(const Idx delta, Search* const newOwner){
         rank +=delta; index += delta;
         status = newOwner;
     }
@@ -133,21 +158,6 @@ public:
     }
     
     
-    inline void addToBlockedList(Search* const search){
-        
-        blockedSearches.push_back(search);
-    
-    }
-    
-
-    
-    inline void blockSearch(Search* const search){
-        
-        
-        blockedSearches.push_back(search);
-    }
-
-    
     //Returns true if and only if the search successfully took ownership of the cell
     //If conquer succeeds, the cell should be added to the conquerer's stack
     inline char claim(Search* const search){
@@ -206,147 +216,95 @@ public:
     }
 
     
-    inline bool allNeighborsDone(){
-        return neighborQueue.empty(); //the queue is set to null when it runs out of neighbors
-    }
+    /* Neighbors are not copied into the cell. The cell keeps a cursor [nextSucc, lastSucc) into the graph's
+     list of the vertex's successors and the worker resolves them through the dictionary one at a time,
+     see Worker::getBestNeighbor(). Successors found to be on another search's stack are set aside in a
+     small lookahead window so that the search can explore unclaimed neighbors first */
     
-    /*Returns a neighbor of this node to be explored. 
-     The function tries to choose a node that is not currently 
-     being explored by another search if one exists.
-     The function assumes the neighbors queue is nonempty*/
-    inline WeakReference<Cell<V>> getBestNeighbor(){
-
-        WeakReference<Cell<V>> candidate = neighborQueue.back();
+    inline void setNeighbors(const V* const first, const V* const last){
+        nextSucc = first; lastSucc = last;
         
-        //If the next element in the queue is not owned by another search,
-        //return it
-        if(isUnclaimed(candidate) || candidate.get()->onStackOf(status))
-            neighborQueue.pop_back();
-        
-        //otherwise try to find a cell in the queue that is not occupied by another
-        //search to avoid conflict. If non found, we hace no choice but to return an occupied cell
-        //Note that this is not sychronized, so the cell might become occupied by the time
-        //we return. This is ok since we make no guarantee that we return an unoccupied cell,
-        //we just try to do so as an optimization
-        
-        else{
-            
-            auto it = neighborQueue.begin();
-            
-            //return first unoccupied cell
-            while(it != neighborQueue.end()){
-                candidate = *it;
-                
-                //is this neighbor occupped? If the neighbor is unclaimed or owned
-                //by the current search, we return it for inspection
-                if(isUnclaimed(candidate) || candidate.get()->onStackOf(status))
-                    break;
-                ++it;
-            }
-            
-            if(it == neighborQueue.end())
-                neighborQueue.pop_back();
-            
-            else
-                neighborQueue.erase(it);
-        }
-        
-        
-        return candidate;
+        if(window) window->size = 0;
     }
     
-    /*Currently unused*/
-    inline WeakReference<Cell<V>> getBestNeighbor2(){
-        
-        WeakReference<Cell<V>> candidate = neighborQueue.back();
+    /*Storage the cursor can point into when the graph only hands out transient spans (see
+     Graph::transientSpans()). The cell carries it to whichever search it is transferred to, and keeps it
+     when it is recycled, so after warm up expanding a vertex does not allocate*/
+    inline std::vector<V>& decodeBuffer(){
+        if(!window)
+            window = new NeighborWindow<V>;
         
-        //If the next element in the queue is not owned by another search,
-        //return it
+        return window->decoded;
+    }
+    
+    inline bool hasUnresolvedNeighbors(){
+        return nextSucc != lastSucc;
+    }
+    
+    inline V nextUnresolvedNeighbor(){
+        return *(nextSucc++);
+    }
+    
+    inline bool windowFull(){
+        return window && window->size == NeighborWindow<V>::CAPACITY;
+    }
+    
+    //Sets aside a neighbor that is currently on another search's stack. Pre: !windowFull()
+    inline void deferNeighbor(const WeakReference<Cell<V>>& neighbor){
+        if(!window)
+            window = new NeighborWindow<V>;
         
-        if(candidate.subject->isComplete(candidate.age)){
-            neighborQueue.pop_back();
-            if(neighborQueue.empty()) return WeakReference<Cell<V>>(nullptr,0);
-        }
+        window->entries[window->size++] = neighbor;
+    }
+    
+    /*Removes a neighbor from the lookahead window, returning false if the window is empty.
+     Neighbors that have since become complete are dropped. As with the cursor, we prefer a neighbor
+     that is no longer occupied by another search, and only return an occupied one if there is no other choice.
+     This is not synchronized, so the returned cell may be occupied by the time the caller looks at it*/
+    inline bool takeDeferredNeighbor(WeakReference<Cell<V>>& neighbor){
         
+        if(!window) return false;
         
-        else if(isUnclaimed(candidate) || candidate.get()->onStackOf(status)){
-            neighborQueue.pop_back(); return candidate;
-        }
-        //otherwise try to find a cell in the queue that is not occupied by another
-        //search to avoid conflict. If non found, we hace no choice but to return an occupied cell
-        //Note that this is not sychronized, so the cell might become occupied by the time
-        //we return. This is ok since we make no guarantee that we return an unoccupied cell,
-        //we just try to do so as an optimization
+        WeakReference<Cell<V>>* const entries(window->entries);
+        int e(0);
         
-        else{
+        while(e < window->size){
+            neighbor = entries[e];
             
-            auto it = neighborQueue.begin();
+            if(neighbor.get()->isComplete(neighbor.age))
+                entries[e] = entries[--window->size]; //Order does not matter, fill the gap with the last entry
             
-            //return first unoccupied cell
-            while(it != neighborQueue.end()){
-                candidate = *it;
-                
-                if(candidate.subject->isComplete(candidate.age)){
-                    it = neighborQueue.erase(it);
-                    if(it == neighborQueue.end()) return WeakReference<Cell<V>>(nullptr,0);
-                }
-                
-                //is this neighbor occupped? If the neighbor is unclaimed or owned
-                //by the current search, we return it for inspection
-                else if(isUnclaimed(candidate) || candidate.get()->onStackOf(status)){
-                    neighborQueue.erase(it); break;
-                }
-                
-                else ++it;
+            else if(isUnclaimed(neighbor) || neighbor.get()->onStackOf(status)){
+                entries[e] = entries[--window->size];
+                return true;
             }
             
-//            if(it == neighborQueue.end())
-//                neighborQueue.pop_back();
-//            
-//            else
-//                neighborQueue.erase(it);
+            else ++e;
         }
         
+        if(!window->size) return false;
         
-        return candidate;
+        neighbor = entries[--window->size];
+        return true;
     }
     
-    void recycle(){
-        ++age;
-        if(blockedSearches.size())
-            (blockedSearches).reset();
-        
+    /*Pre: the cell is complete. Bumps the age so that every WeakReference to the cell reads as complete.
+     The cell object itself may still be read by other workers until the grace period is over, so it
+     must not be reinitialised before then*/
+    inline void retire(){
+        age.fetch_add(2); //The count sits above the HAS_WAITERS bit
     }
     
-    static thread_local std::vector<Cell<V>*>* RECYCLED_CELLS;
-    
-
+    /*Pre: the cell is new or was retired and its grace period is over, so no other thread can be parking
+     on it anymore*/
     inline void initCell(){
+        age.fetch_and(~HAS_WAITERS, std::memory_order_relaxed);
+        
         status = CellStatus::NEW_CELL;
-        ++refCounter; //Creates an artifical reference that protects the cell from being recycled until its complete
-    }
-
-    //Allows the cell to be recycled when all its references run out
-    inline void permitRecycling(){
-        --refCounter;
-    }
-    
-    
-    void recycleThis(){
-            RECYCLED_CELLS->push_back(this);
-            recycle();
-    }
-    
-    inline Reference<Cell<Vid>> getReference(Vid expectedAge){
-        //Return an empty reference if the cell's age exceeds the expected age, as the cell is already complete
-        return this->age == expectedAge? refCounter.createReference() : Reference<Cell<Vid>>::EmptyReference();
     }
     
     
 };
 
-template <class V>
-thread_local std::vector<Cell<V>*>* Cell<V>::RECYCLED_CELLS = nullptr;
-
 
 #endif /* node_h */
@@ -0,0 +1,210 @@
+//
+//  compressedGraph.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/30/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "compressedGraph.hpp"
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+#include "parallelFor.h"
+
+#if defined(__SSSE3__) && !defined(TARJAN_64BIT_IDS)
+#include <tmmintrin.h>
+#define COMPRESSED_SIMD_DECODE
+#endif
+
+namespace{
+
+    //For each control byte, the number of data bytes in its group and the shuffle that spreads them over four 32 bit lanes
+    struct GroupTables{
+        uint8_t length[256];
+        uint8_t shuffle[256][16];
+
+        GroupTables(){
+            for(int control = 0; control < 256; ++control){
+                int source(0);
+
+                for(int value = 0; value < 4; ++value){
+                    const int size(((control >> (2 * value)) & 3) + 1);
+
+                    for(int byte = 0; byte < 4; ++byte)
+                        shuffle[control][4 * value + byte] = byte < size ? (uint8_t) (source + byte) : 0x80; //0x80 zeroes the lane byte
+
+                    source += size;
+                }
+
+                length[control] = (uint8_t) source;
+            }
+        }
+    };
+
+    const GroupTables tables;
+
+}
+
+//Each call sorts its own copy of the successors, which is cheaper than keeping them all sorted
+template <class F>
+void CompressedGraph::forEachSorted(const Graph<Vid>& graph, const Vid* const vertices, const Vid size, const Vid num_threads, F visit){
+    parallelFor(size, num_threads, [&](const Vid begin, const Vid end){
+        std::vector<Vid> sorted; Vid degree;
+
+        for(Vid v = begin; v < end; ++v){
+            const Vid* const succs(graph.getNeighborSpan(vertices[v], degree));
+
+            sorted.assign(succs, succs + degree);
+            std::sort(sorted.begin(), sorted.end());
+
+            visit(vertices[v], sorted.data(), degree);
+        }
+    });
+}
+
+CompressedGraph::CompressedGraph(const Graph<Vid>& graph, const Vid num_threads)
+: n(graph.size()), offsets(n + 1, 0), degrees(n, 0), edges(0){
+
+#ifdef TARJAN_64BIT_IDS
+    if((uint64_t) n > 0xFFFFFFFFULL) throw std::exception(); //Differences must fit in 32 bits
+#endif
+
+    Vid size;
+    const Vid* const vertices(graph.getVerticesArray(size));
+
+    for(Vid v = 0; v < size; ++v)
+        if(vertices[v] >= n) throw std::exception();
+
+    std::atomic<bool> missing(false); //A successor that is not a vertex; we throw here rather than in a worker thread
+
+    //Two passes: the encoded size of each vertex, then, once the offsets are known, the encoding itself
+    forEachSorted(graph, vertices, size, num_threads, [&](const Vid vertex, const Vid* const sorted, const Vid degree){
+        if(degree && sorted[degree - 1] >= n) missing.store(true, std::memory_order_relaxed);
+
+        degrees[vertex] = degree;
+        offsets[vertex + 1] = encodedSize(sorted, degree);
+    });
+
+    if(missing.load()) throw std::exception();
+
+    for(Vid v = 0; v < n; ++v){
+        offsets[v + 1] += offsets[v];
+        edges += degrees[v];
+    }
+
+    bytes.assign(offsets[n] + PADDING, 0);
+
+    forEachSorted(graph, vertices, size, num_threads, [&](const Vid vertex, const Vid* const sorted, const Vid degree){
+        encode(sorted, degree, bytes.data() + offsets[vertex]);
+    });
+
+    vertexList = new Vid[n];
+    for(Vid v = 0; v < n; ++v) vertexList[v] = v;
+}
+
+size_t CompressedGraph::encodedSize(const Vid* const sorted, const Vid degree){
+    size_t size((degree + 3) / 4);
+    Vid previous(0);
+
+    for(Vid i = 0; i < degree; ++i){
+        size += lengthCode((uint32_t) (sorted[i] - previous)) + 1;
+        previous = sorted[i];
+    }
+
+    return size;
+}
+
+void CompressedGraph::encode(const Vid* const sorted, const Vid degree, uint8_t* const out){
+    uint8_t* const control(out);
+    uint8_t* data(out + (degree + 3) / 4);
+    Vid previous(0);
+
+    memset(control, 0, (degree + 3) / 4);
+
+    for(Vid i = 0; i < degree; ++i){
+        const uint32_t delta((uint32_t) (sorted[i] - previous));
+        const unsigned code(lengthCode(delta));
+
+        control[i >> 2] |= code << (2 * (i & 3));
+
+        for(unsigned byte = 0; byte <= code; ++byte)
+            *data++ = (uint8_t) (delta >> (8 * byte));
+
+        previous = sorted[i];
+    }
+}
+
+void CompressedGraph::decode(const uint8_t* const in, const Vid degree, Vid* const out){
+    const uint8_t* const control(in);
+    const uint8_t* data(in + (degree + 3) / 4);
+
+#ifdef COMPRESSED_SIMD_DECODE
+    //Gather each group's four values into lanes, then add up the differences within the group and the last
+    //value of the previous group. A partial last group decodes junk into the lanes past degree, which the
+    //caller leaves room for
+    __m128i base(_mm_setzero_si128());
+
+    for(Vid i = 0; i < degree; i += 4){
+        const uint8_t group(control[i >> 2]);
+
+        __m128i values(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) data),
+                                        _mm_loadu_si128((const __m128i*) tables.shuffle[group])));
+        data += tables.length[group];
+
+        values = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+        values = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+        values = _mm_add_epi32(values, base);
+
+        _mm_storeu_si128((__m128i*) (out + i), values);
+        base = _mm_shuffle_epi32(values, 0xFF);
+    }
+#else
+    const static uint32_t MASK[4] = {0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF};
+    Vid previous(0);
+
+    //Load four bytes and mask off the ones that belong to the next values; the padding covers the overrun
+    for(Vid i = 0; i < degree; ++i){
+        const unsigned code((control[i >> 2] >> (2 * (i & 3))) & 3);
+        uint32_t delta;
+
+        memcpy(&delta, data, sizeof(delta));
+        data += code + 1;
+
+        out[i] = previous += delta & MASK[code];
+    }
+#endif
+}
+
+const Vid* CompressedGraph::decodeNeighbors(const Vid vertex, Vid& degree, std::vector<Vid>& buffer) const{
+    degree = degrees[vertex];
+
+    if(buffer.size() < degree + 3) buffer.resize(degree + 3); //Whole groups of four, see decode()
+
+    decode(bytes.data() + offsets[vertex], degree, buffer.data());
+    return buffer.data();
+}
+
+const Vid* CompressedGraph::getNeighborSpan(const Vid vertex, Vid& degree) const{
+    static thread_local std::vector<Vid> scratch;
+
+    return decodeNeighbors(vertex, degree, scratch);
+}
+
+std::unordered_set<Vid>* CompressedGraph::getVertices() const{
+    std::unordered_set<Vid>* vertices = new std::unordered_set<Vid>;
+
+    for(Vid v = 0; v < n; ++v)
+        vertices->insert(v);
+
+    return vertices;
+}
+
+bool CompressedGraph::edgeExists(const Vid from, const Vid to) const{
+    if(from >= n) return false;
+
+    std::vector<Vid> succs; Vid degree;
+    decodeNeighbors(from, degree, succs);
+
+    return std::binary_search(succs.begin(), succs.begin() + degree, to);
+}
@@ -0,0 +1,109 @@
+//
+//  compressedGraph.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/30/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef compressedGraph_hpp
+#define compressedGraph_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <unordered_set>
+#include <stdint.h>
+#include "typedefs.h"
+#include "graph.h"
+
+/*Read only graph whose successor lists are compressed, for graphs whose 4 bytes per edge do not fit in memory.
+
+ Each vertex's successors are sorted and stored as differences from the previous successor (the first one
+ as is), in the StreamVByte layout (D. Lemire, N. Kurz, C. Rupp, Stream VByte: faster byte-oriented integer
+ compression, 2018): one control byte per group of four values, holding each value's length in bytes
+ minus one, followed by the values' significant bytes. Sorting keeps the differences small, so on graphs
+ with some locality (e.g. after VertexReordering) most edges take one or two bytes.
+
+ Decoding a group of four is one table lookup on the control byte, one byte shuffle and a prefix sum, done
+ with SSSE3 when the compiler targets it (-mssse3 or later) and in scalar code otherwise. The vertices are
+ 0 .. n-1 as in CSRGraph, and the mutators throw.
+
+ Spans are transient, see Graph::transientSpans(): getNeighborSpan decodes into a buffer of the calling
+ thread. The parallel engine decodes into a buffer owned by the cell being expanded instead, and DenseTarjan
+ into one per DFS level. Successors come back sorted, not in insertion order*/
+
+class CompressedGraph: public Graph<Vid>{
+
+private:
+
+    Vid n;
+    std::vector<size_t> offsets; //Start of each vertex's control bytes in bytes, n + 1 entries
+    std::vector<Vid> degrees;
+    std::vector<uint8_t> bytes; //Padded so that a 16 byte load at any group start stays inside
+    size_t edges;
+    Vid* vertexList;
+
+    const static int PADDING = 16;
+
+    //Number of bytes the significant part of value takes, minus one
+    static inline unsigned lengthCode(const uint32_t value){
+        return (value > 0xFF) + (value > 0xFFFF) + (value > 0xFFFFFF);
+    }
+
+    static size_t encodedSize(const Vid* sorted, Vid degree);
+
+    static void encode(const Vid* sorted, Vid degree, uint8_t* out);
+
+    //Pre: out has room for degree + 3 values
+    static void decode(const uint8_t* in, Vid degree, Vid* out);
+
+    //Calls visit(vertex, sorted successors, degree) for every vertex of graph, on num_threads threads
+    template <class F>
+    static void forEachSorted(const Graph<Vid>& graph, const Vid* vertices, Vid size, Vid num_threads, F visit);
+
+public:
+
+    //Copies a graph whose vertices are exactly 0 .. graph.size()-1, and whose edges stay among them, on num_threads threads; throws otherwise
+    CompressedGraph(const Graph<Vid>& graph, Vid num_threads = 4);
+
+    CompressedGraph(const CompressedGraph&) = delete;
+    CompressedGraph& operator=(const CompressedGraph&) = delete;
+
+    virtual ~CompressedGraph(){
+        delete[] vertexList;
+    }
+
+    bool transientSpans() const {return true;}
+
+    const Vid* decodeNeighbors(Vid vertex, Vid& degree, std::vector<Vid>& buffer) const;
+
+    const Vid* getNeighborSpan(Vid vertex, Vid& degree) const;
+
+    inline int size() const {return (int) n;}
+
+    inline bool hasVertex(Vid vertex) const {return vertex < n;}
+
+    Vid* getVerticesArray(Vid& size) const{
+        size = n;
+        return vertexList;
+    }
+
+    std::unordered_set<Vid>* getVertices() const;
+
+    bool edgeExists(Vid from, Vid to) const;
+
+    virtual size_t numberEdges(){return edges;}
+
+    //Bytes taken by the edges and the per vertex offsets and degrees, to compare with a CSRGraph's
+    size_t memoryUse() const{
+        return bytes.size() + offsets.size() * sizeof(size_t) + degrees.size() * sizeof(Vid);
+    }
+
+    void insertVertex(Vid)              {throw std::exception();}
+    void insertEdge(Vid, Vid)           {throw std::exception();}
+    void removeVertex(Vid)              {throw std::exception();}
+    void removeEdge(Vid, Vid)           {throw std::exception();}
+
+};
+
+#endif /* compressedGraph_hpp */
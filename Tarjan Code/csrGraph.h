@@ -0,0 +1,123 @@
+//
+//  csrGraph.h
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/25/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef csrGraph_h
+#define csrGraph_h
+
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include "graph.h"
+
+/*Read only graph in compressed sparse row form. The vertices are 0 .. n-1 and the successors of v are
+ targets[offsets[v]] .. targets[offsets[v+1] - 1], so all edges sit in one array and a vertex's successors
+ are found without hashing. Build it once the graph is final; the mutators throw*/
+
+template <class V>
+class CSRGraph: public Graph<V>{
+
+private:
+
+    Vid n;
+    std::vector<size_t> offsets; //n + 1 entries
+    std::vector<V> targets;
+    V* vertexList;
+
+    void initVertexArray(){
+        vertexList = new V[n];
+        for(Vid v = 0; v < n; ++v) vertexList[v] = v;
+    }
+
+public:
+
+    CSRGraph(const Vid _n, std::vector<size_t>&& _offsets, std::vector<V>&& _targets)
+    : n(_n), offsets(std::move(_offsets)), targets(std::move(_targets)){
+        initVertexArray();
+    }
+
+    //Copies a graph whose vertices are exactly 0 .. graph.size()-1 and whose successors are all vertices; throws otherwise
+    CSRGraph(const Graph<V>& graph) : n(graph.size()), offsets(n + 1, 0){
+        Vid size, degree;
+        const V* const vertices(graph.getVerticesArray(size));
+
+        for(Vid v = 0; v < size; ++v){
+            if(vertices[v] >= n) throw std::exception();
+
+            const V* const succs(graph.getNeighborSpan(vertices[v], degree));
+            offsets[vertices[v] + 1] = degree;
+
+            for(Vid e = 0; e < degree; ++e)
+                if(succs[e] >= n) throw std::exception();
+        }
+
+        for(Vid v = 0; v < n; ++v)
+            offsets[v + 1] += offsets[v];
+
+        targets.resize(offsets[n]);
+
+        for(Vid v = 0; v < size; ++v){
+            const V* const succs(graph.getNeighborSpan(vertices[v], degree));
+            std::copy(succs, succs + degree, targets.begin() + offsets[vertices[v]]);
+        }
+
+        initVertexArray();
+    }
+
+    CSRGraph(const CSRGraph&) = delete;
+    CSRGraph& operator=(const CSRGraph&) = delete;
+
+    virtual ~CSRGraph(){
+        delete[] vertexList;
+    }
+
+    inline const V* getNeighborSpan(V vertex, Vid& degree) const{
+        degree = (Vid) (offsets[vertex + 1] - offsets[vertex]);
+        return targets.data() + offsets[vertex];
+    }
+
+    inline int size() const {return (int) n;}
+
+    inline bool hasVertex(V vertex) const {return vertex < n;}
+
+    V* getVerticesArray(Vid& size) const{
+        size = n;
+        return vertexList;
+    }
+
+    std::unordered_set<V>* getVertices() const{
+        std::unordered_set<V>* vertices = new std::unordered_set<V>;
+
+        for(Vid v = 0; v < n; ++v)
+            vertices->insert(v);
+
+        return vertices;
+    }
+
+    bool edgeExists(V from, V to) const{
+        if(from >= n) return false;
+
+        Vid degree;
+        const V* const succs(getNeighborSpan(from, degree));
+
+        return std::find(succs, succs + degree, to) != succs + degree;
+    }
+
+    virtual size_t numberEdges(){return targets.size();}
+
+    //The edge arrays, for algorithms that walk them directly
+    inline const std::vector<size_t>& getOffsets() const {return offsets;}
+    inline const std::vector<V>&      getTargets() const {return targets;}
+
+    void insertVertex(V)            {throw std::exception();}
+    void insertEdge(V, V)           {throw std::exception();}
+    void removeVertex(V)            {throw std::exception();}
+    void removeEdge(V, V)           {throw std::exception();}
+
+};
+
+#endif /* csrGraph_h */
@@ -0,0 +1,93 @@
+//
+//  denseTarjan.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/25/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "denseTarjan.hpp"
+#include <limits>
+#include <algorithm>
+
+const Idx DenseTarjan::UNVISITED = 0, DenseTarjan::DONE = std::numeric_limits<Idx>::max();
+
+bool DenseTarjan::applicable(const Graph<Vid>& graph){
+    Vid size;
+    const Vid* const vertices(graph.getVerticesArray(size));
+
+    if(!vertices || size != (Vid) graph.size()) return false;
+
+    //Ids below size and no duplicates in the vertex array means the ids are exactly 0 .. size-1
+    for(Vid v = 0; v < size; ++v)
+        if(vertices[v] >= size) return false;
+
+    //The engines index their arrays with successors too, and AdjacencyListGraph::insertEdge does not make
+    //its target a vertex
+    Vid degree;
+
+    for(Vid v = 0; v < size; ++v){
+        const Vid* const succs(graph.getNeighborSpan(vertices[v], degree));
+
+        for(Vid e = 0; e < degree; ++e)
+            if(succs[e] >= size) return false;
+    }
+
+    return true;
+}
+
+SCC_Set* DenseTarjan::run(){
+    const Vid n(graph.size());
+
+    for(Vid vertex = 0; vertex < n; ++vertex)
+        if(index[vertex] == UNVISITED)
+            search(vertex);
+
+    return SCCs;
+}
+
+void DenseTarjan::search(const Vid root){
+    conquer(root);
+
+    while(!controlStack.empty()){
+
+        Frame& curr = controlStack.back();
+
+        //Curr might have more successors not yet assigned to an SCC
+        if(curr.next != curr.end){
+            const Vid child = *curr.next++;
+
+            if(index[child] == UNVISITED)
+                conquer(child); //Invalidates curr
+
+            else if(index[child] != DONE) //On the stack
+                lowlink[curr.vertex] = std::min(lowlink[curr.vertex], index[child]);
+        }
+
+        //curr has no more successors left to explore
+        else{
+            const Vid vertex(curr.vertex);
+            controlStack.pop_back();
+
+            //Update rank of the vertex that linked to curr
+            if(!controlStack.empty()){
+                Idx& parent = lowlink[controlStack.back().vertex];
+                parent = std::min(parent, lowlink[vertex]);
+            }
+
+            if(lowlink[vertex] == index[vertex]){
+                auto scc = new SCC;
+                Vid member;
+
+                do{
+                    member = tarjanStack.back();
+                    tarjanStack.pop_back();
+                    index[member] = DONE;
+                    scc->push_back(member);
+                }while(member != vertex);
+
+                SCCs->push_back(scc);
+            }
+        }
+    }
+}
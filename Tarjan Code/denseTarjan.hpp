@@ -0,0 +1,80 @@
+//
+//  denseTarjan.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/25/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef denseTarjan_hpp
+#define denseTarjan_hpp
+
+#include <stdio.h>
+#include <vector>
+#include "typedefs.h"
+#include "graph.h"
+
+class Tarjan;
+
+/*Iterative single threaded Tarjan for graphs whose vertices are 0 .. n-1, e.g. a CSRGraph.
+ Instead of a hash map of cells, index and lowlink live in flat arrays indexed by vertex, and each frame of
+ the control stack keeps a cursor into the vertex's successor span instead of copying the successors into a
+ per vertex vector. A vertex whose SCC has been found gets index DONE, so a visited vertex is on the stack
+ exactly when its index is not DONE*/
+
+class DenseTarjan{
+
+    friend class Tarjan;
+
+private:
+
+    const static Idx UNVISITED;
+    const static Idx DONE;
+
+    struct Frame{
+        Vid vertex;
+        const Vid* next; //Next successor to inspect
+        const Vid* end;
+    };
+
+    const Graph<Vid>& graph;
+    std::vector<Idx> index, lowlink;
+    std::vector<Frame> controlStack;
+    std::vector<Vid> tarjanStack;
+    Idx cellCount = 0;
+    SCC_Set* SCCs = new SCC_Set;
+
+    DenseTarjan(const Graph<Vid>& _graph) : graph(_graph), index(_graph.size(), UNVISITED), lowlink(_graph.size()),
+                                            transientSpans(_graph.transientSpans()){;}
+
+    //For graphs with transient spans (see Graph::transientSpans()) each DFS level decodes into its own buffer
+    const bool transientSpans;
+    std::vector<std::vector<Vid>> levels;
+
+    inline void conquer(const Vid vertex){
+        Vid degree;
+        const Vid* succs;
+
+        if(transientSpans){
+            if(levels.size() == controlStack.size()) levels.emplace_back();
+            succs = graph.decodeNeighbors(vertex, degree, levels[controlStack.size()]);
+        }
+        else succs = graph.getNeighborSpan(vertex, degree);
+
+        index[vertex] = lowlink[vertex] = ++cellCount;
+        controlStack.push_back(Frame{vertex, succs, succs + degree});
+        tarjanStack.push_back(vertex);
+    }
+
+    void search(Vid root);
+
+    SCC_Set* run();
+
+public:
+
+    //True if the vertices of graph are exactly 0 .. graph.size()-1 and every successor is one of them. O(n + m)
+    static bool applicable(const Graph<Vid>& graph);
+
+};
+
+#endif /* denseTarjan_hpp */
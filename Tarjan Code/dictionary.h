@@ -9,6 +9,8 @@
 #ifndef dictionary_h
 #define dictionary_h
 
+#include <cstddef>
+
 
 /** When a search encounters a vertex on the graph, it needs to check whether a Cell object has already
 been created to represent that vertex. If a cell object already exists for that node, we use this dictionary
@@ -43,6 +45,10 @@ public:
     
     virtual void deleteValues()            = 0;
     
+    //Empties the dictionary so that another run can reuse it, sized for about capacityHint keys (0 for no
+    //hint). Returns false if the implementation does not support this; such a dictionary must be replaced
+    virtual bool reset(size_t = 0) {return false;}
+    
     //An implementation does not need to implement this function nor does it need to guarantee thread
     //safety
     virtual unsigned long size() {return -1;}
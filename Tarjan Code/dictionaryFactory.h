@@ -11,6 +11,11 @@
 #define DictionaryFactory_h
 
 #include "dictionary.h"
+#include "cell.h"
+#include "WeakReference.h"
+#include "mutexDict.h"
+#include "SimpleSharded.h"
+#include "ShardedSpinLock.h"
 #include "openAddressed.h"
 #include "openShardedMap.hpp"
 #include "cuckooDict.h"
@@ -26,7 +31,8 @@ private:
     
 public:
     template <class K, class V>
-    static Dictionary<K, V>*  getDictionary(DictType type){
+    //capacityHint is the number of keys expected; the open addressed maps size their tables from it
+    static Dictionary<K, V>*  getDictionary(DictType type, size_t capacityHint = 0){
         
         switch (type) {
             case Mutex_Dict:
@@ -38,9 +44,9 @@ public:
             case Sharded_SpinLock:
                 return new ShardedSpinLock<K, V>;
             case OpenAddressed:
-                return new OpenAddressedMap;
+                return new OpenAddressedMap<K>(capacityHint ? OpenAddressedMap<K>::initialPow(capacityHint) : 11);
             case OpenSharded:
-                return new OpenAddressedShardedMap;
+                return new OpenAddressedShardedMap<K>(capacityHint);
             case Cuckoo:
                 return new CuckooMap<K, V>;
             default:
@@ -0,0 +1,610 @@
+//
+//  dynamicSCC.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/18/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "dynamicSCC.hpp"
+#include "tarjan.hpp"
+#include <algorithm>
+
+DynamicSCC::DynamicSCC(Graph<Vid>& _graph, const SCC_Set& SCCs) : graph(_graph), numAlive(0), nextOrder(0), stamp(0){
+
+    components.reserve(SCCs.size());
+
+    for(SCC* scc: SCCs){
+        const Comp component(newComponent());
+        components[component].members = *scc;
+
+        for(Vid vertex: *scc)
+            label[vertex] = component;
+    }
+
+    //Build the condensation. Successors missing from the decomposition become singletons first,
+    //since adding components may move the vector we iterate over
+    std::vector<std::pair<Vid, Vid>> edges;
+    Vid degree;
+
+    for(Comp component = 0; component < components.size(); ++component)
+        for(Vid vertex: components[component].members){
+            if(!graph.hasVertex(vertex)) continue;
+
+            const Vid* const succs(graph.getNeighborSpan(vertex, degree));
+
+            for(Vid i = 0; i < degree; ++i)
+                edges.emplace_back(vertex, succs[i]);
+        }
+
+    for(auto& edge: edges){
+        const Comp from(label[edge.first]), to(componentOrNew(edge.second));
+
+        if(from != to)
+            addCondensationEdge(from, to, 1);
+    }
+
+    topologicalSort();
+}
+
+DynamicSCC::Comp DynamicSCC::newComponent(){
+    Comp component;
+
+    if(freeLabels.empty()){
+        component = (Comp) components.size();
+        components.emplace_back();
+    }
+    else{
+        component = freeLabels.back();
+        freeLabels.pop_back();
+        components[component].alive = true;
+    }
+
+    setOrder(component, nextOrder);
+    nextOrder += GAP;
+    ++numAlive;
+
+    return component;
+}
+
+//Release the memory, the label is reused for the next new component
+void DynamicSCC::freeComponent(const Comp component){
+    Component& gone(components[component]);
+
+    gone.alive = false;
+    std::vector<Vid>().swap(gone.members);
+    std::unordered_map<Comp, Vid>().swap(gone.out);
+    std::unordered_map<Comp, Vid>().swap(gone.in);
+    freeLabels.push_back(component);
+    --numAlive;
+}
+
+void DynamicSCC::setOrder(const Comp component, const int64_t order){
+    components[component].order = order;
+    byOrder[order] = component;
+}
+
+DynamicSCC::Comp DynamicSCC::componentOrNew(const Vid vertex){
+    auto entry(label.find(vertex));
+
+    if(entry != label.end())
+        return entry->second;
+
+    const Comp component(newComponent());
+    components[component].members.push_back(vertex);
+    label[vertex] = component;
+
+    return component;
+}
+
+void DynamicSCC::addCondensationEdge(const Comp from, const Comp to, const Vid count){
+    components[from].out[to] += count;
+    components[to].in[from]  += count;
+}
+
+//Drops count graph edges from the condensation edge, removing the edge once none are left
+void DynamicSCC::removeCondensationEdge(const Comp from, const Comp to, const Vid count){
+    auto out(components[from].out.find(to));
+
+    if(out == components[from].out.end()) return;
+
+    if(out->second <= count){
+        components[from].out.erase(out);
+        components[to].in.erase(from);
+    }
+    else{
+        out->second -= count;
+        components[to].in[from] -= count;
+    }
+}
+
+//Numbers the components in a topological order of the condensation (Kahn's algorithm)
+void DynamicSCC::topologicalSort(){
+    std::vector<Vid> inDegree(components.size(), 0);
+    stack.clear();
+
+    for(Comp component = 0; component < components.size(); ++component){
+        if(!components[component].alive) continue;
+
+        inDegree[component] = (Vid) components[component].in.size();
+        if(!inDegree[component])
+            stack.push_back(component);
+    }
+
+    nextOrder = 0;
+    byOrder.clear();
+
+    while(!stack.empty()){
+        const Comp component(stack.back());
+        stack.pop_back();
+        setOrder(component, nextOrder);
+        nextOrder += GAP;
+
+        for(auto& succ: components[component].out)
+            if(--inDegree[succ.first] == 0)
+                stack.push_back(succ.first);
+    }
+}
+
+//Spreads the order labels spacing apart, keeping the order
+void DynamicSCC::relabelAll(const int64_t spacing){
+    std::map<int64_t, Comp> old;
+    old.swap(byOrder);
+    nextOrder = 0;
+
+    for(auto& entry: old){
+        setOrder(entry.second, nextOrder);
+        nextOrder += spacing;
+    }
+}
+
+Vid DynamicSCC::insertEdges(const std::vector<std::pair<Vid, Vid>>& edges){
+    const Vid before(numAlive);
+    Vid added(0);
+
+    for(auto& edge: edges){
+        if(!label.count(edge.first))  ++added;
+        if(!label.count(edge.second) && edge.second != edge.first) ++added;
+
+        insertEdge(edge.first, edge.second);
+    }
+
+    return before + added - numAlive;
+}
+
+void DynamicSCC::insertEdge(const Vid from, const Vid to){
+
+    //Both endpoints have to be vertices of the graph, not just the tail
+    if(!graph.hasVertex(to))
+        graph.insertVertex(to);
+
+    graph.insertEdge(from, to);
+
+    const Comp tail(componentOrNew(from)), head(componentOrNew(to));
+
+    if(tail == head) return; //Edge inside a component, the condensation does not change
+
+    addCondensationEdge(tail, head, 1);
+
+    //If the edge agrees with the order (which is always the case if the condensation already had it)
+    //there is nothing else to do
+    if(components[head].order < components[tail].order)
+        reorder(tail, head);
+}
+
+/*Pearce-Kelly step for a new condensation edge tail -> head with order(head) < order(tail).
+ Only components with orders in [order(head), order(tail)] can be affected: we search forward from head and
+ backward from tail within that window. Components found by both lie on a cycle with the new edge and are merged.
+ The others keep their relative order, those that reach tail placed before those reachable from head,
+ in the order labels the affected components held before*/
+void DynamicSCC::reorder(const Comp tail, const Comp head){
+    const int64_t lower(components[head].order), upper(components[tail].order);
+
+    //Forward search from head
+    const uint64_t forwardStamp(++stamp);
+    forward.clear(); stack.clear();
+    stack.push_back(head); components[head].visited = forwardStamp;
+
+    while(!stack.empty()){
+        const Comp component(stack.back());
+        stack.pop_back();
+        forward.push_back(component);
+
+        for(auto& succ: components[component].out){
+            Component& next(components[succ.first]);
+
+            if(next.visited != forwardStamp && next.order <= upper){
+                next.visited = forwardStamp;
+                stack.push_back(succ.first);
+            }
+        }
+    }
+
+    //Backward search from tail. A component the forward search found as well is on a cycle
+    const uint64_t backwardStamp(++stamp);
+    std::vector<Comp> cycle;
+    backward.clear();
+    stack.push_back(tail);
+
+    const bool tailInForward(components[tail].visited == forwardStamp);
+    if(tailInForward) cycle.push_back(tail); else backward.push_back(tail);
+    components[tail].visited = backwardStamp;
+
+    while(!stack.empty()){
+        const Comp component(stack.back());
+        stack.pop_back();
+
+        for(auto& pred: components[component].in){
+            Component& prev(components[pred.first]);
+
+            if(prev.visited != backwardStamp && prev.order >= lower){
+
+                if(prev.visited == forwardStamp) cycle.push_back(pred.first);
+                else backward.push_back(pred.first);
+
+                prev.visited = backwardStamp;
+                stack.push_back(pred.first);
+            }
+        }
+    }
+
+    //Forward components the backward search did not reach still carry the forward stamp
+    std::vector<Comp> onlyForward;
+    for(Comp component: forward)
+        if(components[component].visited == forwardStamp)
+            onlyForward.push_back(component);
+
+    //Hand the affected components' order labels back out
+    std::vector<int64_t> orders;
+    orders.reserve(forward.size() + backward.size());
+
+    for(Comp component: forward)  orders.push_back(components[component].order);
+    for(Comp component: backward) orders.push_back(components[component].order);
+
+    std::sort(orders.begin(), orders.end());
+
+    auto earlier = [this](const Comp c1, const Comp c2){ return components[c1].order < components[c2].order; };
+    std::sort(backward.begin(), backward.end(), earlier);
+    std::sort(onlyForward.begin(), onlyForward.end(), earlier);
+
+    size_t next(0);
+    for(Comp component: backward)
+        setOrder(component, orders[next++]);
+
+    //The forward components take the largest labels
+    const size_t firstForward(orders.size() - onlyForward.size());
+
+    if(!cycle.empty()){
+        const Comp merged(merge(cycle));
+        setOrder(merged, orders[next]);
+        
+        //The labels of the merged away components are left as a gap
+        while(++next < firstForward)
+            byOrder.erase(orders[next]);
+    }
+
+    next = firstForward;
+    for(Comp component: onlyForward)
+        setOrder(component, orders[next++]);
+}
+
+/*Merges the components on a cycle into the one with the most vertices and returns it. Edges between the
+ merged components become internal; all others are moved over to the surviving component*/
+DynamicSCC::Comp DynamicSCC::merge(const std::vector<Comp>& cycle){
+
+    Comp survivor(cycle[0]);
+    for(Comp component: cycle)
+        if(components[component].members.size() > components[survivor].members.size())
+            survivor = component;
+
+    const uint64_t cycleStamp(++stamp);
+    for(Comp component: cycle)
+        components[component].visited = cycleStamp;
+
+    auto inCycle = [&](const Comp component){ return components[component].visited == cycleStamp; };
+
+    Component& kept(components[survivor]);
+
+    //Edges of the survivor into the rest of the cycle are now internal
+    for(Comp component: cycle){
+        kept.out.erase(component); kept.in.erase(component);
+    }
+
+    for(Comp component: cycle){
+        if(component == survivor) continue;
+
+        Component& gone(components[component]);
+
+        for(Vid vertex: gone.members)
+            label[vertex] = survivor;
+
+        kept.members.insert(kept.members.end(), gone.members.begin(), gone.members.end());
+
+        for(auto& succ: gone.out){
+            if(inCycle(succ.first)) continue;
+
+            components[succ.first].in.erase(component);
+            addCondensationEdge(survivor, succ.first, succ.second);
+        }
+
+        for(auto& pred: gone.in){
+            if(inCycle(pred.first)) continue;
+
+            components[pred.first].out.erase(component);
+            addCondensationEdge(pred.first, survivor, pred.second);
+        }
+
+        freeComponent(component);
+    }
+
+    return survivor;
+}
+
+Vid DynamicSCC::removeEdges(const std::vector<std::pair<Vid, Vid>>& edges, const Vid num_threads){
+    const Vid before(numAlive);
+    const uint64_t affectedStamp(++stamp);
+    std::vector<Comp> affected;
+
+    for(auto& edge: edges){
+        if(!label.count(edge.first) || !label.count(edge.second)) continue;
+
+        const Vid copies(removeEdge(edge.first, edge.second));
+        const Comp tail(label[edge.first]), head(label[edge.second]);
+
+        if(!copies) continue;
+
+        if(tail != head)
+            removeCondensationEdge(tail, head, copies);
+
+        else if(components[tail].visited != affectedStamp){
+            components[tail].visited = affectedStamp;
+            affected.push_back(tail);
+        }
+    }
+
+    recompute(affected, num_threads);
+
+    return numAlive - before;
+}
+
+//Removes every copy of the edge from the graph and returns how many there were
+Vid DynamicSCC::removeEdge(const Vid from, const Vid to){
+    if(!graph.hasVertex(from)) return 0;
+
+    const std::vector<Vid>& succs(graph.getNeighborsVector(from));
+    const Vid copies((Vid) std::count(succs.begin(), succs.end(), to));
+
+    if(copies)
+        graph.removeEdge(from, to);
+
+    return copies;
+}
+
+Vid DynamicSCC::removeVertices(const std::vector<Vid>& vertices, const Vid num_threads){
+    const uint64_t affectedStamp(++stamp);
+    std::vector<Comp> affected;
+    Vid vanished(0);
+    const Vid before(numAlive);
+
+    for(Vid vertex: vertices){
+        auto entry(label.find(vertex));
+        if(entry == label.end()) continue;
+
+        const Comp component(entry->second);
+
+        //Edges into the vertex can only come from its own component or its predecessors
+        std::vector<Comp> sources{component};
+        for(auto& pred: components[component].in)
+            sources.push_back(pred.first);
+
+        for(Comp source: sources){
+            for(Vid member: components[source].members){
+                if(member == vertex) continue;
+
+                const Vid copies(removeEdge(member, vertex));
+                if(copies && source != component)
+                    removeCondensationEdge(source, component, copies);
+            }
+        }
+
+        //Edges out of the vertex
+        if(graph.hasVertex(vertex)){
+            for(Vid succ: graph.getNeighborsVector(vertex)){
+                auto succLabel(label.find(succ));
+                if(succLabel != label.end() && succLabel->second != component)
+                    removeCondensationEdge(component, succLabel->second, 1);
+            }
+
+            graph.removeVertex(vertex);
+        }
+
+        label.erase(entry);
+
+        std::vector<Vid>& members(components[component].members);
+        members.erase(std::find(members.begin(), members.end(), vertex));
+
+        if(members.empty()){
+            byOrder.erase(components[component].order);
+            freeComponent(component);
+            ++vanished;
+        }
+        else if(components[component].visited != affectedStamp){
+            components[component].visited = affectedStamp;
+            affected.push_back(component);
+        }
+    }
+
+    //A component can vanish after it was marked as affected
+    std::vector<Comp> stillAlive;
+    for(Comp component: affected)
+        if(components[component].alive && components[component].visited == affectedStamp)
+            stillAlive.push_back(component);
+
+    recompute(stillAlive, num_threads);
+
+    return numAlive + vanished - before;
+}
+
+/*Restricts a run to the vertices that currently carry one component label. Searches start from the
+ component's members, so the run never looks at the rest of the graph*/
+class ComponentFilter : public SubgraphFilter{
+    
+    const std::unordered_map<Vid, DynamicSCC::Comp>& label;
+    const std::vector<Vid>& members;
+    const DynamicSCC::Comp component;
+    
+public:
+    
+    ComponentFilter(const std::unordered_map<Vid, DynamicSCC::Comp>& _label, const std::vector<Vid>& _members, DynamicSCC::Comp _component) : label(_label), members(_members), component(_component){;}
+    
+    inline bool hasVertex(const Vid vertex) const{
+        auto entry(label.find(vertex));
+        return entry != label.end() && entry->second == component;
+    }
+    
+    const Vid* getVertices(Vid& size) const{
+        size = (Vid) members.size();
+        return members.data();
+    }
+    
+};
+
+//Recomputes the SCCs of each affected component on the subgraph induced by its vertices
+void DynamicSCC::recompute(const std::vector<Comp>& affected, const Vid num_threads){
+
+    for(Comp component: affected){
+        const std::vector<Vid>& members(components[component].members);
+
+        if(members.size() < 2) continue; //A single vertex cannot split
+
+        ComponentFilter induced(label, members, component);
+
+        SCC_Set* pieces(members.size() >= PARALLEL_THRESHOLD && num_threads > 1 ?
+                        Tarjan::multiThreadedTarjan(graph, induced, num_threads) : Tarjan::singleThreadedTarjan(graph, induced));
+
+        if(pieces->size() > 1)
+            split(component, *pieces);
+
+        for(SCC* piece: *pieces) delete piece;
+        delete pieces;
+    }
+}
+
+/*Replaces component by the pieces it fell apart into. The first piece keeps the component's label. The
+ condensation edges of the pieces are rebuilt from the out edges of their vertices and of the vertices of
+ the component's predecessors. The pieces are then ordered among themselves and placed in the gap between
+ the component's order label and the next label in use*/
+void DynamicSCC::split(const Comp component, const SCC_Set& pieces){
+
+    //Detach the old component from the condensation
+    std::vector<Comp> preds;
+    for(auto& pred: components[component].in){
+        preds.push_back(pred.first);
+        components[pred.first].out.erase(component);
+    }
+
+    for(auto& succ: components[component].out)
+        components[succ.first].in.erase(component);
+
+    components[component].in.clear(); components[component].out.clear();
+
+    //Make sure the gap behind the old label has room for every piece
+    auto after(byOrder.upper_bound(components[component].order));
+    if(after != byOrder.end() && after->first - components[component].order < (int64_t) pieces.size())
+        relabelAll((int64_t) pieces.size() > GAP ? (int64_t) pieces.size() : GAP);
+
+    const int64_t order(components[component].order);
+    byOrder.erase(order);
+    --numAlive; //newComponent() counts the first piece again below
+
+    //Label the pieces. The first one reuses the old label
+    std::vector<Comp> labels;
+    const uint64_t pieceStamp(++stamp);
+
+    for(SCC* piece: pieces){
+        Comp pieceLabel;
+
+        if(labels.empty()){
+            pieceLabel = component;
+            ++numAlive;
+        }
+        else
+            pieceLabel = newComponent();
+
+        components[pieceLabel].members = *piece;
+        components[pieceLabel].visited = pieceStamp;
+        labels.push_back(pieceLabel);
+
+        for(Vid vertex: *piece)
+            label[vertex] = pieceLabel;
+    }
+
+    //Rebuild the condensation edges of the pieces
+    for(Comp pieceLabel: labels)
+        for(Vid vertex: components[pieceLabel].members)
+            for(Vid succ: graph.getNeighborsVector(vertex)){
+                auto succLabel(label.find(succ));
+                if(succLabel != label.end() && succLabel->second != pieceLabel)
+                    addCondensationEdge(pieceLabel, succLabel->second, 1);
+            }
+
+    for(Comp pred: preds)
+        for(Vid vertex: components[pred].members)
+            for(Vid succ: graph.getNeighborsVector(vertex)){
+                auto succLabel(label.find(succ));
+                if(succLabel != label.end() && components[succLabel->second].visited == pieceStamp)
+                    addCondensationEdge(pred, succLabel->second, 1);
+            }
+
+    //Order the pieces among themselves (Kahn's algorithm on the edges between pieces)
+    std::unordered_map<Comp, Vid> inDegree;
+    for(Comp pieceLabel: labels){
+        inDegree[pieceLabel];
+        for(auto& succ: components[pieceLabel].out)
+            if(components[succ.first].visited == pieceStamp)
+                ++inDegree[succ.first];
+    }
+
+    std::vector<Comp> sorted;
+    stack.clear();
+    for(Comp pieceLabel: labels)
+        if(!inDegree[pieceLabel])
+            stack.push_back(pieceLabel);
+
+    while(!stack.empty()){
+        const Comp pieceLabel(stack.back());
+        stack.pop_back();
+        sorted.push_back(pieceLabel);
+
+        for(auto& succ: components[pieceLabel].out)
+            if(components[succ.first].visited == pieceStamp && --inDegree[succ.first] == 0)
+                stack.push_back(succ.first);
+    }
+
+    //newComponent() put the new pieces at the end of the order, take them out again
+    for(Comp pieceLabel: labels)
+        if(pieceLabel != component)
+            byOrder.erase(components[pieceLabel].order);
+
+    //Place the pieces in the gap behind the old label
+    after = byOrder.upper_bound(order);
+    const int64_t end(after == byOrder.end() ? order + GAP * (int64_t) sorted.size() : after->first);
+    const int64_t step((end - order) / (int64_t) sorted.size());
+
+    for(size_t i = 0; i < sorted.size(); ++i)
+        setOrder(sorted[i], order + (int64_t) i * step);
+
+    if(nextOrder <= byOrder.rbegin()->first)
+        nextOrder = byOrder.rbegin()->first + GAP;
+}
+
+SCC_Set* DynamicSCC::getSCCs() const{
+    SCC_Set* SCCs(new SCC_Set);
+    SCCs->reserve(numAlive);
+
+    for(const Component& component: components)
+        if(component.alive)
+            SCCs->push_back(new SCC(component.members));
+
+    return SCCs;
+}
@@ -0,0 +1,141 @@
+//
+//  dynamicSCC.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/18/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef dynamicSCC_hpp
+#define dynamicSCC_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include "typedefs.h"
+#include "graph.h"
+
+/** Keeps the SCCs of a graph up to date as edges are added and removed, instead of rerunning Tarjan from scratch.
+
+ It is seeded with the graph and an SCC decomposition of it, e.g. from Tarjan::multiThreadedTarjan, and
+ maintains
+
+    - a component label for every vertex
+    - the condensation, the DAG of components, with the number of graph edges behind each of its edges
+    - a topological order of the condensation
+
+ The order is kept with the Pearce-Kelly dynamic topological sort. An edge between two components that
+ agrees with the order costs O(1). Otherwise only the components whose order lies between the edge's
+ endpoints are searched: forward from the head and backward from the tail. The components found by both
+ searches are exactly those the new edge closes into a cycle; they are merged into one component, and the
+ other components found are reordered using the order labels the searches freed up. Order labels are
+ integers with gaps, so no other component is ever renumbered. A batch therefore costs time proportional
+ to the components it affects and their edges, not to the whole graph.
+
+ When components merge, the vertices of the smaller components are relabelled to the largest one.
+ 
+ Deleting an edge between two components only updates the condensation, since removing a DAG edge can
+ neither split a component nor break the order. Deleting an edge inside a component, or a vertex, may split
+ that component. After a batch of deletions each such component is recomputed on its own: Tarjan runs on the
+ subgraph induced by its vertices through a SubgraphFilter, without copying the graph (the parallel engine
+ for large components), and the pieces replace it.
+ The pieces are ordered among themselves and take order labels from the gap behind the old component's
+ label, so the rest of the order stands. Only if that gap is too small are all labels spread out again.
+ */
+
+class DynamicSCC{
+
+public:
+
+    typedef Vid Comp; //Component label
+
+protected:
+
+    struct Component{
+        bool alive = true;
+        int64_t order; //Position in the topological order of the condensation; only compared, may have gaps
+        uint64_t visited = 0; //Stamp of the last search that visited the component
+        std::vector<Vid> members;
+        std::unordered_map<Comp, Vid> out; //Successor component -> number of graph edges into it
+        std::unordered_map<Comp, Vid> in;  //Predecessor component -> number of graph edges from it
+    };
+
+    const static int64_t GAP = 1 << 16; //Spacing of order labels after a full relabel, leaves room for splits
+
+    //Components of at least this many vertices are recomputed with the parallel engine
+    const static Vid PARALLEL_THRESHOLD = 1 << 14;
+
+    Graph<Vid>& graph;
+    std::unordered_map<Vid, Comp> label;
+    std::vector<Component> components;
+    std::vector<Comp> freeLabels; //Labels of merged away components, reused for new ones
+    std::map<int64_t, Comp> byOrder; //Order label -> component, to find the gap behind a component
+    Vid numAlive;
+    int64_t nextOrder; //Larger than every order label in use
+    uint64_t stamp;
+
+    //Buffers reused by every insertion
+    std::vector<Comp> forward, backward, stack;
+
+    Comp newComponent();
+    Comp componentOrNew(Vid vertex);
+    void freeComponent(Comp component);
+    void setOrder(Comp component, int64_t order);
+    void addCondensationEdge(Comp from, Comp to, Vid count);
+    void removeCondensationEdge(Comp from, Comp to, Vid count);
+    void topologicalSort();
+    void relabelAll(int64_t spacing);
+    void insertEdge(Vid from, Vid to);
+    void reorder(Comp tail, Comp head);
+    Comp merge(const std::vector<Comp>& cycle);
+    Vid removeEdge(Vid from, Vid to);
+    void recompute(const std::vector<Comp>& affected, Vid num_threads);
+    void split(Comp component, const SCC_Set& pieces);
+
+public:
+
+    DynamicSCC(Graph<Vid>& _graph, const SCC_Set& SCCs);
+
+    /*Adds the edges to the graph and updates the components. Vertices not in the graph yet are added as
+     singleton components. Returns the number of components that disappeared by merging.
+     As with any change to the graph, call graph.updateVertexArray() before running a fresh Tarjan on it if
+     the batch added vertices*/
+    Vid insertEdges(const std::vector<std::pair<Vid, Vid>>& edges);
+
+    /*Removes the edges (every copy of each) from the graph and splits the components that fall apart.
+     Components are recomputed with num_threads threads. Returns the number of new components*/
+    Vid removeEdges(const std::vector<std::pair<Vid, Vid>>& edges, Vid num_threads = 4);
+    
+    /*Removes the vertices and their incident edges from the graph and splits the components that fall apart.
+     Edges into a removed vertex are found through the condensation, so only the vertex's component and its
+     predecessors are scanned. Returns the number of new components, not counting components that vanished*/
+    Vid removeVertices(const std::vector<Vid>& vertices, Vid num_threads = 4);
+
+    inline Comp componentOf(const Vid vertex) const{
+        return label.at(vertex);
+    }
+
+    inline bool sameComponent(const Vid v1, const Vid v2) const{
+        return label.at(v1) == label.at(v2);
+    }
+
+    inline const std::vector<Vid>& members(const Comp component) const{
+        return components[component].members;
+    }
+
+    inline Vid numComponents() const{
+        return numAlive;
+    }
+
+    //True if c1 comes before c2 in the topological order, so there can be no path from c2 to c1
+    inline bool precedes(const Comp c1, const Comp c2) const{
+        return components[c1].order < components[c2].order;
+    }
+
+    //The current SCCs in the same form the Tarjan engines return. The caller owns the result
+    SCC_Set* getSCCs() const;
+
+};
+
+#endif /* dynamicSCC_hpp */
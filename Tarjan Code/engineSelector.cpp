@@ -0,0 +1,122 @@
+//
+//  engineSelector.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/24/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "engineSelector.hpp"
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+
+/*Samples up to AUTO_SAMPLES vertices at an even stride for the degree statistics and runs a few breadth
+ first searches of at most AUTO_REACH_LIMIT vertices. Costs O(AUTO_SAMPLES + AUTO_REACH_SAMPLES * AUTO_REACH_LIMIT)
+ successor lookups however big the graph is*/
+GraphStats EngineSelector::sample(const Graph<Vid>& graph){
+    GraphStats stats;
+    Vid size, degree;
+    const Vid* const vertices(graph.getVerticesArray(size));
+
+    stats.vertices = size;
+    if(!size) return stats;
+
+    const Vid samples(std::min<Vid>(size, AUTO_SAMPLES));
+    const Vid stride(size / samples);
+    double degrees(0); Vid sinks(0);
+
+    for(Vid s = 0; s < samples; ++s){
+        graph.getNeighborSpan(vertices[s * stride], degree);
+
+        degrees += degree;
+        stats.maxDegree = std::max(stats.maxDegree, degree);
+        if(!degree) ++sinks;
+    }
+
+    stats.averageDegree = degrees / samples;
+    stats.edgesEstimate = stats.averageDegree * size;
+    stats.trivialRatio  = double(sinks) / samples;
+
+    //Bounded searches. If they keep hitting the limit the graph is well connected
+    const Vid reachSamples(std::min<Vid>(size, AUTO_REACH_SAMPLES));
+    const Vid reachStride(size / reachSamples);
+    double reached(0);
+    std::unordered_set<Vid> seen;
+    std::vector<Vid> frontier;
+
+    for(Vid s = 0; s < reachSamples; ++s){
+        seen.clear(); frontier.clear();
+
+        const Vid root(vertices[s * reachStride]);
+        seen.insert(root); frontier.push_back(root);
+
+        for(size_t next = 0; next < frontier.size() && seen.size() < AUTO_REACH_LIMIT; ++next){
+            const Vid* const succs(graph.getNeighborSpan(frontier[next], degree));
+
+            for(Vid i = 0; i < degree && seen.size() < AUTO_REACH_LIMIT; ++i)
+                if(seen.insert(succs[i]).second && graph.hasVertex(succs[i]))
+                    frontier.push_back(succs[i]);
+        }
+
+        reached += double(seen.size()) / AUTO_REACH_LIMIT;
+    }
+
+    stats.reachRatio = reached / reachSamples;
+
+    return stats;
+}
+
+void EngineSelector::choose(RunStats& stats, const Vid maxThreads){
+    const GraphStats& graph(stats.graph);
+
+    stats.parallel = false; stats.threads = 1;
+
+    if(maxThreads < 2){
+        stats.reason = "only one thread available";
+        return;
+    }
+
+    if(graph.vertices < AUTO_MIN_PARALLEL_VERTICES){
+        stats.reason = "graph too small for the parallel engine";
+        return;
+    }
+
+    if(graph.trivialRatio > AUTO_MAX_TRIVIAL_RATIO && graph.vertices < 10 * AUTO_MIN_PARALLEL_VERTICES){
+        stats.reason = "mostly sinks, too little work per vertex to split";
+        return;
+    }
+
+    stats.parallel = true;
+    stats.threads  = std::max<Vid>(2, std::min<Vid>(maxThreads, graph.vertices / AUTO_VERTICES_PER_THREAD));
+    stats.dType    = graph.vertices >= AUTO_SHARDED_DICT_VERTICES ? OpenSharded : OpenAddressed;
+
+    stats.reason = "large graph";
+
+    if(stats.threads > AUTO_MAX_THREADS){
+        stats.threads = AUTO_MAX_THREADS;
+        stats.reason += ", capped at " + std::to_string(AUTO_MAX_THREADS) + " threads";
+    }
+
+    //Searches from well connected roots reach most of the graph and spend their time blocking on each other
+    //rather than running in parallel, so use fewer threads
+    if(graph.reachRatio >= 1.0 && graph.averageDegree < 2){
+        stats.threads = std::max<Vid>(2, stats.threads / 2);
+        stats.reason += ", long chains: fewer threads";
+    }
+}
+
+void RunStats::print(std::ostream& out) const{
+    out << (parallel ? "parallel" : "sequential") << " engine";
+
+    if(parallel)
+        out << ", " << threads << " threads, " << (dType == OpenSharded ? "OpenSharded" : dType == OpenAddressed ? "OpenAddressed" : "other") << " dictionary";
+
+    out << " (" << reason << ")" << std::endl;
+
+    out << "  vertices: " << graph.vertices << ", edges ~" << (size_t) graph.edgesEstimate
+        << ", avg degree: " << graph.averageDegree << ", max sampled degree: " << graph.maxDegree
+        << ", sinks: " << graph.trivialRatio << ", reach: " << graph.reachRatio << std::endl;
+
+    out << "  " << numSCCs << " SCCs in " << seconds << "s" << std::endl;
+}
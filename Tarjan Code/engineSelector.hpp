@@ -0,0 +1,64 @@
+//
+//  engineSelector.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/24/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef engineSelector_hpp
+#define engineSelector_hpp
+
+#include <stdio.h>
+#include <iostream>
+#include <string>
+#include "typedefs.h"
+#include "graph.h"
+#include "dictionaryFactory.h"
+
+//Thresholds used by the auto mode. Tune them for the machine
+#define AUTO_MIN_PARALLEL_VERTICES   20000   //Below this the parallel engine's setup costs more than it saves
+#define AUTO_VERTICES_PER_THREAD     20000   //Do not add a thread for fewer vertices than this
+#define AUTO_MAX_THREADS             63      //MultiThreadedTarjan keeps one done flag per worker in a 64 bit word
+#define AUTO_SHARDED_DICT_VERTICES   (1 << 20) //Below this one growing table beats thousands of shard tables
+#define AUTO_MAX_TRIVIAL_RATIO       0.8     //If more sampled vertices than this are sinks, the work is too cheap to split
+#define AUTO_SAMPLES                 1024    //Vertices whose degree is sampled
+#define AUTO_REACH_SAMPLES           4       //Vertices a bounded search is started from
+#define AUTO_REACH_LIMIT             4096    //Vertices a bounded search may visit
+
+//Cheap statistics of a graph, from a sample of its vertices
+struct GraphStats{
+    Vid    vertices        = 0;
+    double edgesEstimate   = 0; //Sampled average degree times the number of vertices
+    double averageDegree   = 0;
+    Vid    maxDegree       = 0; //Largest sampled degree
+    double trivialRatio    = 0; //Sampled fraction of vertices without successors; they are singleton SCCs
+    double reachRatio      = 0; //Average fraction of AUTO_REACH_LIMIT the bounded searches reached
+};
+
+//What a run did and why. The auto mode fills in the decision; the run itself adds the outcome
+struct RunStats{
+    GraphStats  graph;
+    bool        parallel  = false;
+    Vid         threads   = 1;
+    DictType    dType     = OpenSharded;
+    std::string reason;
+
+    double      seconds   = 0;
+    size_t      numSCCs   = 0;
+
+    void print(std::ostream& out = std::cout) const;
+};
+
+class EngineSelector{
+
+public:
+
+    static GraphStats sample(const Graph<Vid>& graph);
+
+    //Fills in the decision (engine, thread count, dictionary and the reason) of stats from stats.graph
+    static void choose(RunStats& stats, Vid maxThreads);
+
+};
+
+#endif /* engineSelector_hpp */
@@ -0,0 +1,92 @@
+//
+//  epochManager.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/9/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef epochManager_hpp
+#define epochManager_hpp
+
+#include <atomic>
+#include "typedefs.h"
+#include "alignedArray.h"
+
+/** Epoch based reclamation for cells.
+
+ A worker may read a cell it found through the dictionary at any time, so a completed cell cannot
+ be handed out for another vertex right away. Instead of counting references to each cell, the
+ workers announce the global epoch they saw at their last quiescent point (a point where they hold no
+ pointer to a cell that is not on their own search's stack). A cell retired in epoch e may be reused once
+ the global epoch reaches e + 2: the epoch only advances when every active worker has announced the
+ current one, so by then every worker has passed a quiescent point since the cell was retired.
+
+ The age of a retired cell is still bumped straight away, so a WeakReference to it reads as complete.
+ The epoch only guarantees that the cell object is not reinitialised while someone is looking at it.
+
+ Workers that are idle (sleeping in getSearch or finished) announce QUIESCENT and never hold up the epoch.
+ */
+
+class EpochManager{
+
+private:
+
+    const static uint64_t QUIESCENT = UINT64_MAX;
+
+    //Each announcement gets its own cache line so that workers do not invalidate each other's
+    struct alignas(64) Announcement{
+        std::atomic<uint64_t> epoch{QUIESCENT};
+    };
+
+    alignas(64) std::atomic<uint64_t> globalEpoch{0};
+    const unsigned int NUM_THREADS;
+    AlignedArray<Announcement> announced;
+
+public:
+
+    EpochManager(unsigned int num_threads) : NUM_THREADS(num_threads), announced(num_threads){;}
+
+    /*Marks a quiescent point for worker ID and announces the current epoch. Every cell read after this call
+     is protected until the worker's next call to enter() or exit(). The fence orders the announcement
+     before any of those reads*/
+    inline void enter(const unsigned int ID){
+        announced[ID].epoch.store(globalEpoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    //The worker no longer reads any cells, e.g. it is about to sleep
+    inline void exit(const unsigned int ID){
+        announced[ID].epoch.store(QUIESCENT, std::memory_order_release);
+    }
+
+    //The epoch a cell retired now should be tagged with
+    inline uint64_t current(){
+        return globalEpoch.load();
+    }
+
+    /*Advances the global epoch if every active worker has announced the current one. Returns the
+     global epoch after the attempt*/
+    uint64_t tryAdvance(){
+        uint64_t epoch(globalEpoch.load());
+
+        for(unsigned int ID = 0; ID < NUM_THREADS; ++ID){
+            const uint64_t seen(announced[ID].epoch.load());
+            if(seen != QUIESCENT && seen != epoch)
+                return epoch;
+        }
+
+        //If the CAS fails someone else advanced the epoch, which is just as good
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+        return globalEpoch.load();
+    }
+
+    //Can a cell retired in epoch retiredIn be reused now that the global epoch is now?
+    static inline bool gracePeriodOver(const uint64_t retiredIn, const uint64_t now){
+        return now >= retiredIn + 2;
+    }
+
+};
+
+
+#endif /* epochManager_hpp */
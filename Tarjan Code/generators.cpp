@@ -0,0 +1,325 @@
+//
+//  generators.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 10/1/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "generators.hpp"
+#include <math.h>
+#include <algorithm>
+#include "parallelFor.h"
+
+namespace{
+
+    const Vid CHUNK = 1024; //Vertices whose rows are buffered together
+
+    //Calls take(i) for every i in [0, count) picked independently with probability p, in increasing order
+    template <class F>
+    inline void sampleSkipping(CounterRNG& rng, const Vid count, const double p, F take){
+        if(p <= 0) return;
+
+        if(p >= 1){
+            for(Vid i = 0; i < count; ++i) take(i);
+            return;
+        }
+
+        const double logMiss(log1p(-p));
+
+        //The gap to the next pick is geometric; a double holds positions far past count without overflowing
+        for(double i = -1;;){
+            i += 1 + floor(log(1 - rng.uniform()) / logMiss);
+            if(i >= count) return;
+
+            take((Vid) i);
+        }
+    }
+
+    //The geometric generator's distance term from the squared distance, d^(1/8) as in Utility::GeoGenerateRandomGraph
+    inline double spread(const double squared){
+        return sqrt(sqrt(sqrt(sqrt(squared))));
+    }
+
+}
+
+template <class F>
+CSRGraph<Vid>* Generators::buildRows(const Vid n, const uint64_t seed, const Vid num_threads, F row){
+    const Vid chunks((n + CHUNK - 1) / CHUNK);
+
+    std::vector<std::vector<Vid>> buffered(chunks);
+    std::vector<size_t> offsets(n + 1, 0);
+
+    parallelFor(chunks, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid chunk = begin; chunk < end; ++chunk){
+            std::vector<Vid>& out(buffered[chunk]);
+            const Vid last(std::min(n, (chunk + 1) * CHUNK));
+
+            for(Vid v = chunk * CHUNK; v < last; ++v){
+                CounterRNG rng(seed, v);
+                const size_t before(out.size());
+
+                row(v, rng, out);
+                offsets[v + 1] = out.size() - before;
+            }
+        }
+    });
+
+    for(Vid v = 0; v < n; ++v)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<Vid> targets(offsets[n]);
+
+    parallelFor(chunks, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid chunk = begin; chunk < end; ++chunk){
+            std::copy(buffered[chunk].begin(), buffered[chunk].end(), targets.begin() + offsets[chunk * CHUNK]);
+            std::vector<Vid>().swap(buffered[chunk]);
+        }
+    });
+
+    return new CSRGraph<Vid>(n, std::move(offsets), std::move(targets));
+}
+
+CSRGraph<Vid>* Generators::erdosRenyi(const Vid n, const double edgeProb, const uint64_t seed, const Vid num_threads){
+
+    return buildRows(n, seed, num_threads, [&](const Vid, CounterRNG& rng, std::vector<Vid>& out){
+        sampleSkipping(rng, n, edgeProb, [&](const Vid w){out.push_back(w);});
+    });
+}
+
+CSRGraph<Vid>* Generators::geometric(const Vid n, const double edgeProb, const double corr, const uint64_t seed, const Vid num_threads){
+
+    //Points come from their own streams so that they do not depend on the edges drawn
+    std::vector<double> x(n), y(n);
+
+    parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid v = begin; v < end; ++v){
+            CounterRNG rng(~seed, v);
+            x[v] = rng.uniform(); y[v] = rng.uniform();
+        }
+    });
+
+    const Vid side(std::max((Vid) 1, (Vid) std::min(sqrt(n * std::max(edgeProb, 0.0)), sqrt((double) n))));
+    const Vid cells(side * side);
+
+    auto cellOf = [&](const Vid v){
+        return std::min(side - 1, (Vid) (y[v] * side)) * side + std::min(side - 1, (Vid) (x[v] * side));
+    };
+
+    //Vertices sorted by cell, a counting sort
+    std::vector<Vid> cellStart(cells + 1, 0), byCell(n);
+
+    for(Vid v = 0; v < n; ++v) ++cellStart[cellOf(v) + 1];
+    for(Vid c = 0; c < cells; ++c) cellStart[c + 1] += cellStart[c];
+
+    {
+        std::vector<Vid> fill(cellStart.begin(), cellStart.end() - 1);
+        for(Vid v = 0; v < n; ++v) byCell[fill[cellOf(v)]++] = v;
+    }
+
+    auto probability = [&](const Vid v, const Vid w){
+        const double dx(x[v] - x[w]), dy(y[v] - y[w]);
+        return edgeProb * (1 - corr * spread(dx * dx + dy * dy));
+    };
+
+    return buildRows(n, seed, num_threads, [&](const Vid v, CounterRNG& rng, std::vector<Vid>& out){
+        const Vid home(cellOf(v)), homeX(home % side), homeY(home / side);
+
+        for(Vid cell = 0; cell < cells; ++cell){
+            const Vid cellX(cell % side), cellY(cell / side);
+
+            //Distance from v's cell to the nearest point of this one, in whole cells between them
+            const double gapX((double) std::max(std::max(cellX, homeX) - std::min(cellX, homeX), (Vid) 1) - 1);
+            const double gapY((double) std::max(std::max(cellY, homeY) - std::min(cellY, homeY), (Vid) 1) - 1);
+
+            const double bound(std::min(1.0, edgeProb * (1 - corr * spread((gapX * gapX + gapY * gapY) / cells))));
+            if(bound <= 0) continue;
+
+            const Vid* const members(byCell.data() + cellStart[cell]);
+
+            sampleSkipping(rng, cellStart[cell + 1] - cellStart[cell], bound, [&](const Vid i){
+                const Vid w(members[i]);
+
+                if(w != v && rng.uniform() * bound < probability(v, w))
+                    out.push_back(w);
+            });
+        }
+    });
+}
+
+CSRGraph<Vid>* Generators::clusters(const Vid numClusters, const Vid clusterSize, const Vid numNeighbors,
+                                    const Vid interClusterConnections, const uint64_t seed, const Vid num_threads){
+
+    return buildRows(numClusters * clusterSize, seed, num_threads, [&](const Vid v, CounterRNG& rng, std::vector<Vid>& out){
+        const Vid cluster(v % numClusters), position(v / numClusters);
+
+        for(Vid edge = 0; edge < numNeighbors; ++edge)
+            out.push_back(cluster + (Vid) rng.below(clusterSize) * numClusters);
+
+        if(cluster == numClusters - 1) return;
+
+        //Connection j leaves from the cluster's vertex j % clusterSize
+        for(Vid j = position; j < interClusterConnections; j += clusterSize){
+            const Vid target(cluster + 1 + (Vid) rng.below(numClusters - cluster - 1));
+            out.push_back((Vid) rng.below(clusterSize) * numClusters + target);
+        }
+    });
+}
+
+CSRGraph<Vid>* Generators::rmat(const Vid scale, const Vid edgeFactor, const double a, const double b, const double c,
+                                const uint64_t seed, const Vid num_threads){
+    const Vid n((Vid) 1 << scale);
+    const size_t m((size_t) edgeFactor * n), EDGE_CHUNK(1 << 16);
+    const Vid chunks((Vid) ((m + EDGE_CHUNK - 1) / EDGE_CHUNK));
+
+    //Quadrant thresholds on 32 bit draws, two levels per number drawn
+    const uint64_t AB((uint64_t) ((a + b) * 4294967296.0)), A((uint64_t) (a * 4294967296.0)),
+                   ABC((uint64_t) ((a + b + c) * 4294967296.0));
+
+    //Edges are drawn per chunk of the edge list, each chunk from its own stream, then bucketed by source
+    std::vector<Vid> from(m), to(m);
+    std::vector<std::atomic<Vid>> degree(n);
+
+    parallelFor(chunks, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid chunk = begin; chunk < end; ++chunk){
+            CounterRNG rng(seed, chunk);
+            const size_t last(std::min(m, (chunk + 1) * EDGE_CHUNK));
+
+            for(size_t e = chunk * EDGE_CHUNK; e < last; ++e){
+                Vid u(0), v(0);
+                uint64_t bits(0);
+
+                for(Vid level = 0; level < scale; ++level){
+                    if(!(level & 1)) bits = rng.next();
+
+                    const uint64_t r(bits & 0xFFFFFFFF); bits >>= 32;
+
+                    u = (u << 1) | (r >= AB);
+                    v = (v << 1) | ((r >= A && r < AB) || r >= ABC);
+                }
+
+                from[e] = u; to[e] = v;
+                degree[u].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    std::vector<size_t> offsets(n + 1, 0);
+
+    for(Vid v = 0; v < n; ++v)
+        offsets[v + 1] = offsets[v] + degree[v].load(std::memory_order_relaxed);
+
+    std::vector<Vid> targets(m);
+    std::vector<std::atomic<size_t>> cursor(n);
+
+    for(Vid v = 0; v < n; ++v) cursor[v].store(offsets[v], std::memory_order_relaxed);
+
+    parallelFor(chunks, num_threads, [&](const Vid begin, const Vid end){
+        const size_t last(std::min(m, end * EDGE_CHUNK));
+
+        for(size_t e = begin * EDGE_CHUNK; e < last; ++e)
+            targets[cursor[from[e]].fetch_add(1, std::memory_order_relaxed)] = to[e];
+    });
+
+    //The scatter order depends on timing, sorting each row makes the graph depend on the seed alone
+    parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid v = begin; v < end; ++v)
+            std::sort(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+    });
+
+    return new CSRGraph<Vid>(n, std::move(offsets), std::move(targets));
+}
+
+PlantedGraph Generators::planted(const std::vector<Vid>& sizes, const Vid innerDegree, const Vid dagDegree,
+                                 const uint64_t seed, const Vid num_threads){
+    const Vid components((Vid) sizes.size());
+
+    //Positions run through the components in order; label[p] is the id of the vertex at position p
+    std::vector<Vid> start(components + 1, 0);
+
+    for(Vid c = 0; c < components; ++c)
+        start[c + 1] = start[c] + sizes[c];
+
+    const Vid n(start[components]);
+    std::vector<Vid> label(n), position(n);
+
+    for(Vid p = 0; p < n; ++p) label[p] = p;
+
+    CounterRNG shuffle(~seed, 0);
+    for(Vid p = n; p > 1; --p)
+        std::swap(label[p - 1], label[shuffle.below(p)]);
+
+    PlantedGraph planted;
+    planted.sizes = sizes;
+    planted.component.resize(n);
+
+    parallelFor(components, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid c = begin; c < end; ++c)
+            for(Vid p = start[c]; p < start[c + 1]; ++p){
+                position[label[p]] = p;
+                planted.component[label[p]] = c;
+            }
+    });
+
+    auto randomIn = [&](CounterRNG& rng, const Vid c){
+        return label[start[c] + (Vid) rng.below(sizes[c])];
+    };
+
+    planted.graph = buildRows(n, seed, num_threads, [&](const Vid v, CounterRNG& rng, std::vector<Vid>& out){
+        const Vid c(planted.component[v]), k(sizes[c]), i(position[v] - start[c]);
+
+        if(k > 1){
+            out.push_back(label[start[c] + (i + 1) % k]); //The cycle through the component
+
+            for(Vid e = 1; e < innerDegree; ++e)
+                out.push_back(randomIn(rng, c));
+        }
+
+        if(c + 1 == components) return;
+
+        //Edge t of the component leaves from its member t % k. Edge 0 is the one to the next component
+        for(Vid t = i; t <= dagDegree; t += k)
+            out.push_back(randomIn(rng, t ? c + 1 + (Vid) rng.below(components - c - 1) : c + 1));
+    });
+
+    return planted;
+}
+
+std::vector<Vid> Generators::powerLawSizes(const Vid n, const double exponent, const Vid maxSize, const uint64_t seed){
+    std::vector<Vid> sizes;
+    CounterRNG rng(seed, 0);
+    Vid total(0);
+
+    while(total < n){
+        //Pareto with minimum 1: P(size > x) = x^(1 - exponent)
+        const double draw(pow(1 - rng.uniform(), -1 / (exponent - 1)));
+        const Vid size(std::min(n - total, (Vid) std::min((double) std::max(maxSize, (Vid) 1), floor(draw))));
+
+        sizes.push_back(size);
+        total += size;
+    }
+
+    return sizes;
+}
+
+bool PlantedGraph::matches(const SCC_Set& SCCs) const{
+    if(SCCs.size() != sizes.size()) return false;
+
+    std::vector<bool> foundComponent(sizes.size(), false), foundVertex(component.size(), false);
+
+    for(const SCC* const scc: SCCs){
+        if(scc->empty() || scc->front() >= component.size()) return false;
+
+        const Vid c(component[scc->front()]);
+        if(foundComponent[c] || scc->size() != sizes[c]) return false;
+
+        foundComponent[c] = true;
+
+        for(const Vid v: *scc){
+            if(v >= component.size() || component[v] != c || foundVertex[v]) return false;
+            foundVertex[v] = true;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,119 @@
+//
+//  generators.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 10/1/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef generators_hpp
+#define generators_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <stdint.h>
+#include <atomic>
+#include "typedefs.h"
+#include "csrGraph.h"
+
+/*Random number stream keyed by (seed, stream). The i-th number is a hash of the key and i, so a stream can be
+ started on any thread without sharing state, and a generator that gives every vertex its own stream produces
+ the same graph whatever the number of threads*/
+class CounterRNG{
+
+    uint64_t key, counter;
+
+    static inline uint64_t mix(uint64_t x){
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+public:
+
+    CounterRNG(const uint64_t seed, const uint64_t stream) : key(mix(seed) ^ mix(stream + 0x9e3779b97f4a7c15ULL)), counter(0){;}
+
+    inline uint64_t next(){
+        return mix(key + 0x9e3779b97f4a7c15ULL * ++counter);
+    }
+
+    //Uniform in [0, 1)
+    inline double uniform(){
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    //Uniform in [0, range)
+    inline uint64_t below(const uint64_t range){
+        return (uint64_t) (((unsigned __int128) next() * range) >> 64);
+    }
+
+};
+
+/*Graph generators that run in expected O(n + m) on num_threads threads and return a CSRGraph over 0 .. n-1.
+ They draw from the same distributions as Utility::generateRandomGraph, GeoGenerateRandomGraph and clusters,
+ which try all n^2 vertex pairs on one global engine, but each vertex draws from its own CounterRNG stream:
+ a given seed gives the same graph on any number of threads*/
+
+/*A graph with known SCCs, see Generators::planted. Vertices of one component are scattered over the ids,
+ so the structure is not visible from the numbering. The caller owns graph*/
+struct PlantedGraph{
+    CSRGraph<Vid>*   graph;
+    std::vector<Vid> component; //component[v] is the SCC of v. Components are numbered in topological order
+    std::vector<Vid> sizes;     //Number of vertices in each component
+
+    //True if SCCs is exactly the planted partition, so a run can be checked without the sequential algorithm
+    bool matches(const SCC_Set& SCCs) const;
+};
+
+class Generators{
+
+    //Fills rows in parallel: row(v, rng, out) appends the successors of v. Rows are buffered per chunk of
+    //vertices, then copied into the edge array once the offsets are known
+    template <class F>
+    static CSRGraph<Vid>* buildRows(Vid n, uint64_t seed, Vid num_threads, F row);
+
+public:
+
+    /*Each of the n^2 ordered pairs (self loops included) is an edge with probability edgeProb. Instead of a coin
+     per pair, each vertex jumps from one successor to the next by a geometrically distributed gap*/
+    static CSRGraph<Vid>* erdosRenyi(Vid n, double edgeProb, uint64_t seed, Vid num_threads = 4);
+
+    /*Vertices get random points in the unit square, and v has an edge to w != v with probability
+     edgeProb * (1 - corr * d^(1/8)), d their distance, as in Utility::GeoGenerateRandomGraph.
+
+     Points are bucketed in a grid. For a vertex and a grid cell, the probability is at most the one at the
+     cell's nearest point, so candidates in the cell are drawn with geometric gaps at that bound and each is
+     kept with the exact probability over the bound. The grid has about n * edgeProb cells, so the bound is
+     tight and the cells a vertex visits are few next to its candidates*/
+    static CSRGraph<Vid>* geometric(Vid n, double edgeProb, double corr, uint64_t seed, Vid num_threads = 4);
+
+    /*Same structure as Utility::clusters: vertex cluster + x * numClusters has numNeighbors edges into its own
+     cluster, and interClusterConnections edges leave each cluster but the last for random later clusters,
+     starting at the cluster's vertices in turn*/
+    static CSRGraph<Vid>* clusters(Vid numClusters, Vid clusterSize, Vid numNeighbors, Vid interClusterConnections,
+                                   uint64_t seed, Vid num_threads = 4);
+
+    /*R-MAT graph (D. Chakrabarti, Y. Zhan, C. Faloutsos, R-MAT: a recursive model for graph mining, 2004) with
+     2^scale vertices and edgeFactor * 2^scale edges. Each edge picks its quadrant of the adjacency matrix with
+     probabilities a, b, c and 1-a-b-c, scale times over, which gives power law degrees. a = 0.57, b = c = 0.19
+     are the Graph500 values. Low ids get most of the edges; relabel with VertexReordering if that matters.
+     Successors are sorted*/
+    static CSRGraph<Vid>* rmat(Vid scale, Vid edgeFactor, double a, double b, double c, uint64_t seed, Vid num_threads = 4);
+
+    /*Graph whose SCCs are planted: component i has sizes[i] vertices joined by a cycle through all of them,
+     plus innerDegree - 1 random edges per vertex inside the component. Component i has an edge to component i+1
+     and dagDegree more to random later components, so the condensation is a DAG holding a path through every
+     component and no other SCCs can form. For example:
+     
+        {n}                     one giant SCC
+        (k, size) repeated      k medium SCCs chained in a DAG
+        (n, 1), dagDegree 0     one long path without cycles
+        powerLawSizes(...)      component sizes with a heavy tail*/
+    static PlantedGraph planted(const std::vector<Vid>& sizes, Vid innerDegree, Vid dagDegree, uint64_t seed, Vid num_threads = 4);
+
+    //Component sizes from a Pareto distribution with the given exponent (> 1), capped at maxSize, adding up to n
+    static std::vector<Vid> powerLawSizes(Vid n, double exponent, Vid maxSize, uint64_t seed);
+
+};
+
+#endif /* generators_hpp */
@@ -10,6 +10,7 @@
 #define graph_h
 
 #include <unordered_set>
+#include <vector>
 #include <iostream>
 #include "typedefs.h"
 
@@ -38,6 +39,24 @@ public:
     virtual const std::vector<V>& getNeighborsVector(V vertex)  const
     {throw std::exception(); }
     
+    //Returns a pointer to the vertex's successors, which must be stored contiguously and stay put
+    //while the graph is not modified. degree is set to the number of successors
+    virtual const V* getNeighborSpan(V vertex, Vid& degree)     const {
+        const std::vector<V>& neighbors = getNeighborsVector(vertex);
+        degree = (Vid) neighbors.size();
+        return neighbors.data();
+    }
+    
+    /*Graphs that store successors compressed, e.g. CompressedGraph, decode them on request. The span from
+     getNeighborSpan is then only valid until the calling thread's next call, so algorithms that hold on to
+     spans (a cell's cursor, a DFS frame) check this and decode into storage they own with decodeNeighbors*/
+    virtual bool transientSpans() const {return false;}
+    
+    //Returns the successors, decoded into buffer if the graph does not store them as a span
+    virtual const V* decodeNeighbors(V vertex, Vid& degree, std::vector<V>&) const {
+        return getNeighborSpan(vertex, degree);
+    }
+    
     virtual size_t numberEdges(){return -1;}
     
     //Methods with a standard implementation
@@ -0,0 +1,72 @@
+//
+//  leanTarjan.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/26/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "leanTarjan.hpp"
+
+SCC_Set* LeanTarjan::run(){
+
+    for(Vid vertex = 0; vertex < n; ++vertex)
+        if(!rindex[vertex])
+            search(vertex);
+
+    return SCCs;
+}
+
+void LeanTarjan::search(const Vid start){
+    Vid degree;
+    beginVisiting(start);
+
+    while(!dfsStack.empty()){
+
+        Frame& curr = dfsStack.back();
+        const Vid* const succs = successors(curr.vertex, degree);
+
+        //Inspect successors until we find an unvisited one to descend into
+        while(curr.edge < degree && rindex[succs[curr.edge]])
+            finishEdge(curr.vertex, succs[curr.edge++]);
+
+        if(curr.edge < degree){
+            ++curr.edge; //The tree edge is finished once the child returns
+            beginVisiting(succs[curr.edge - 1]); //Invalidates curr
+            continue;
+        }
+
+        const Vid v(curr.vertex);
+        dfsStack.pop_back();
+        finishVisiting(v);
+
+        if(!dfsStack.empty())
+            finishEdge(dfsStack.back().vertex, v);
+    }
+}
+
+void LeanTarjan::finishVisiting(const Vid v){
+
+    if(!isRoot(v)){
+        stack.push_back(v);
+        return;
+    }
+
+    //v is the root of a component: it and everything above it on the stack with rindex >= rindex[v]
+    auto scc = new SCC;
+
+    --index;
+    while(!stack.empty() && rindex[v] <= rindex[stack.back()]){
+        const Vid w(stack.back());
+        stack.pop_back();
+
+        rindex[w] = component;
+        --index;
+        scc->push_back(w);
+    }
+
+    rindex[v] = component--;
+    scc->push_back(v);
+
+    SCCs->push_back(scc);
+}
@@ -0,0 +1,115 @@
+//
+//  leanTarjan.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/26/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef leanTarjan_hpp
+#define leanTarjan_hpp
+
+#include <stdio.h>
+#include <vector>
+#include "typedefs.h"
+#include "graph.h"
+
+class Tarjan;
+
+/*Sequential SCC algorithm for the largest graphs, after Pearce's space efficient variant of Tarjan
+ (D. J. Pearce, A space-efficient algorithm for finding strongly connected components, 2016).
+ Per vertex it keeps one word, rindex, plus one root bit, against SingleCell's index, rank, status,
+ neighbor vector and hash map entry.
+
+ rindex is 0 for unvisited vertices and holds the lowlink while a vertex is on the stack. When a component
+ completes, its vertices get the component's number in rindex. Components are numbered down from n while
+ indices count up from 1 and are given back as components complete, so component numbers always exceed the
+ index of any vertex still on the stack. Edges into finished components therefore never lower a lowlink
+ and need no separate check.
+
+ The DFS stack holds (vertex, edge position) pairs, and the successor span is looked up again when a frame
+ resumes. Graphs with transient spans (see Graph::transientSpans()) are decoded once per frame instead, into a
+ buffer per DFS level. The graph's vertices must be 0 .. n-1 and every successor one of them, which
+ DenseTarjan::applicable checks; rindex is indexed by successors unchecked*/
+
+class LeanTarjan{
+
+    friend class Tarjan;
+
+private:
+
+    struct Frame{
+        Vid vertex;
+        Vid edge; //Position of the next successor to inspect
+    };
+
+    struct Level{
+        std::vector<Vid> buffer;
+        const Vid* succs;
+        Vid degree;
+    };
+
+    const Graph<Vid>& graph;
+    const Vid n;
+    std::vector<Vid> rindex;
+    std::vector<uint64_t> root; //One bit per vertex: no successor has reached below it yet
+    std::vector<Frame> dfsStack;
+    std::vector<Vid> stack; //Visited vertices that are not roots, waiting for their root to complete
+    Vid index = 1, component;
+    SCC_Set* SCCs = new SCC_Set;
+
+    //Decoding a compressed list again on every resume would cost O(degree^2) per vertex
+    const bool transientSpans;
+    std::vector<Level> levels;
+
+    LeanTarjan(const Graph<Vid>& _graph) : graph(_graph), n(_graph.size()), rindex(n, 0),
+                                           root((n + 63) / 64, 0), component(n), transientSpans(_graph.transientSpans()){;}
+
+    inline bool isRoot(const Vid v) const{
+        return (root[v >> 6] >> (v & 63)) & 1;
+    }
+
+    inline void setRoot(const Vid v, const bool value){
+        if(value) root[v >> 6] |= 1ULL << (v & 63);
+        else      root[v >> 6] &= ~(1ULL << (v & 63));
+    }
+
+    inline void beginVisiting(const Vid v){
+        dfsStack.push_back(Frame{v, 0});
+        setRoot(v, true);
+        rindex[v] = index++;
+
+        if(transientSpans){
+            const size_t depth(dfsStack.size() - 1);
+            if(levels.size() == depth) levels.emplace_back();
+            levels[depth].succs = graph.decodeNeighbors(v, levels[depth].degree, levels[depth].buffer);
+        }
+    }
+
+    //Successors of v, the vertex on top of the DFS stack
+    inline const Vid* successors(const Vid v, Vid& degree){
+        if(!transientSpans)
+            return graph.getNeighborSpan(v, degree);
+
+        const Level& level(levels[dfsStack.size() - 1]);
+        degree = level.degree;
+        return level.succs;
+    }
+
+    //v has reached w, directly or through the tree edge to w
+    inline void finishEdge(const Vid v, const Vid w){
+        if(rindex[w] < rindex[v]){
+            rindex[v] = rindex[w];
+            setRoot(v, false);
+        }
+    }
+
+    void finishVisiting(Vid v);
+
+    void search(Vid start);
+
+    SCC_Set* run();
+
+};
+
+#endif /* leanTarjan_hpp */
@@ -14,6 +14,8 @@
 #include <thread>
 #include "simpleClock.h"
 #include "utilities.hpp"
+#include "generators.hpp"
+#include "microbenchmarks.hpp"
 #include "SimpleSharded.h"
 #include "suspensionManager.hpp"
 #include <dirent.h>
@@ -35,6 +37,9 @@ void benchmark_Clusters(Vid , Vid , bool = true, const int  = 100, const std::in
 
 #define DISPLAY_SCC_COUNT false
 #define INIT_RUNS 0
+#define BENCH_AFFINITY NoAffinity //Pin the benchmark's workers to cut run to run variance, see AffinityPolicy
+#define BENCH_REORDER NoReorder //Relabel the graph for locality before timing it, see ReorderPolicy
+#define BENCH_SEED 2017 //Generated benchmark graphs are the same from run to run, see Generators
 
 
 void sleeps(int secs){
@@ -129,6 +134,8 @@ int main(int argc, const char * argv[]) {
    // benchmark_CSP("/Users/alex/Downloads/CSP/Alt/", "alt10.3.2.graph", 1, 5, 8);
     
   //  benchmarkHashTables();
+    
+  //  Microbenchmarks::runAll(); //Dictionaries, queues and the other concurrent pieces on their own, see Microbenchmarks
 
     
     return 0;
@@ -432,6 +439,16 @@ void benchmarkGraph(Graph<Vid>* graph, string name, bool benchSingle, const int
     
     SimpleClock profiler; string msg;
     
+    //The timed runs use the relabelled graph; the SCCs are not mapped back since they are only counted
+    if(BENCH_REORDER != NoReorder){
+        profiler.begin();
+        Graph<Vid>* const reordered = VertexReordering::reorder(*graph, BENCH_REORDER, 8);
+        profiler.end("reordering " + name);
+        
+        delete graph; graph = reordered;
+        name += string(" (") + reorderPolicyName(BENCH_REORDER) + ")";
+    }
+    
     //BenchMark Single Threaded
     
     if(benchSingle){
@@ -453,15 +470,17 @@ void benchmarkGraph(Graph<Vid>* graph, string name, bool benchSingle, const int
         
     }
     
+    CancellationToken neverCancelled;
+    
     for(int THDS : THREADS){
         for(int run = 0; run < INIT_RUNS; ++run){
-            auto sccs = Tarjan::multiThreadedTarjan(*graph, THDS);
+            auto sccs = Tarjan::multiThreadedTarjan(*graph, neverCancelled, THDS, OpenSharded, false, Affinity(BENCH_AFFINITY)).SCCs;
             Utility::deleteSCCs(sccs);
         }
         
         for(int run = 0; run < RUNS; ++run){
             profiler.begin();
-            auto sccs = Tarjan::multiThreadedTarjan(*graph, THDS);
+            auto sccs = Tarjan::multiThreadedTarjan(*graph, neverCancelled, THDS, OpenSharded, false, Affinity(BENCH_AFFINITY)).SCCs;
             profiler.accumulate();
             if(DISPLAY_SCC_COUNT) std::cout<< sccs->size() << ",";
             Utility::deleteSCCs(sccs);
@@ -488,7 +507,7 @@ void benchmark_CSP(string path, string filename, bool benchSingle, const int RUN
 
 void benchmark_Clusters(Vid clusters, Vid clustSize, bool benchSingle, const int RUNS, const std::initializer_list<int> THREADS){
     
-    Graph<Vid>* const graph   = Utility::clusters(clusters, clustSize, 8, 50);
+    Graph<Vid>* const graph   = Generators::clusters(clusters, clustSize, 8, 50, BENCH_SEED);
     
     string graphName = "Clust_" + to_string(clusters) + "X" + to_string(clustSize);
     
@@ -500,7 +519,7 @@ void benchmark_Clusters(Vid clusters, Vid clustSize, bool benchSingle, const int
 
 void benchmark_GeoGen(double edgeProb, Vid cardinality, bool benchSingle, const int RUNS, const std::initializer_list<int> THREADS){
     
-    Graph<Vid>* graph = Utility::GeoGenerateRandomGraph(edgeProb, 1, cardinality);
+    Graph<Vid>* graph = Generators::geometric(cardinality, edgeProb, 1, BENCH_SEED);
 
     string graphName = "Geo_" + to_string(cardinality);
     
@@ -0,0 +1,357 @@
+//
+//  microbenchmarks.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 10/3/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "microbenchmarks.hpp"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include "blockedList.hpp"
+#include "waitTable.hpp"
+#include "epochManager.hpp"
+#include "pending.hpp"
+#include "stealingQueue.hpp"
+#include "multiThreadedTarjan.hpp"
+#include "cancellationToken.h"
+#include "csrGraph.h"
+#include "generators.hpp"
+#include "alignedArray.h"
+
+namespace{
+
+    //The queues only store and hand back search pointers, so the benchmarks use distinct fake ones
+    inline Search* fakeSearch(const uint64_t i){
+        return reinterpret_cast<Search*>((uintptr_t) (i + 1) * 64);
+    }
+
+}
+
+template <class F>
+double Microbenchmarks::timeThreads(const unsigned int num_threads, F body){
+    std::atomic<unsigned int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+
+    for(unsigned int t = 0; t < num_threads; ++t)
+        threads.emplace_back([&, t](){
+            ++ready;
+            while(!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(t);
+        });
+
+    while(ready.load() < num_threads) std::this_thread::yield();
+
+    const auto start(std::chrono::steady_clock::now());
+    go.store(true, std::memory_order_release);
+
+    for(std::thread& thread: threads) thread.join();
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Microbenchmarks::report(const std::string& name, const unsigned int num_threads, const uint64_t ops, std::vector<double>& seconds){
+    std::sort(seconds.begin(), seconds.end());
+    const double median(seconds[seconds.size() / 2]);
+
+    std::cout << std::left << std::setw(60) << name << std::right
+              << std::setw(3) << num_threads << " threads"
+              << std::fixed << std::setprecision(0) << std::setw(14) << ops / median << " ops/sec"
+              << std::setprecision(2) << std::setw(10) << median * num_threads * 1e9 / ops << " ns/op"
+              << std::defaultfloat << std::endl;
+}
+
+const char* Microbenchmarks::dictTypeName(const DictType type){
+    switch(type){
+        case Mutex_Dict:        return "Mutex_Dict";
+        case Sharded_Locked:    return "Sharded_Locked";
+        case Sharded_SpinLock:  return "Sharded_SpinLock";
+        case TBB_Conc:          return "TBB_Conc";
+        case OpenAddressed:     return "OpenAddressed";
+        case OpenSharded:       return "OpenSharded";
+        case Cuckoo:            return "Cuckoo";
+        default:                return "Unknown";
+    }
+}
+
+void Microbenchmarks::dictionaries(const std::vector<DictType>& types, const std::vector<unsigned int>& threads,
+                                   const double hitRatio, const Vid hotKeys, const Vid putsPerThread){
+    Cell<Vid> cell; cell.initCell();
+    const WeakReference<Cell<Vid>> value(&cell, cell.getAge());
+
+    for(const unsigned int num_threads: threads){
+        //Key sequences are drawn once per thread count, so every dictionary type does the same puts
+        std::vector<std::vector<Vid>> keys(num_threads);
+        size_t inserts(hotKeys);
+
+        for(unsigned int t = 0; t < num_threads; ++t){
+            CounterRNG rng(SEED, t);
+            Vid fresh(hotKeys + t * putsPerThread);
+
+            keys[t].resize(putsPerThread);
+            for(Vid& key: keys[t]){
+                if(hotKeys && rng.uniform() < hitRatio)
+                    key = (Vid) rng.below(hotKeys);
+                else{
+                    key = fresh++; ++inserts;
+                }
+            }
+        }
+
+        for(const DictType type: types){
+            std::vector<double> seconds;
+
+            for(int run = 0; run < REPEATS; ++run){
+                Dictionary<Vid, WeakReference<Cell<Vid>>>* const dict(DictionaryFactory::getDictionary<Vid, WeakReference<Cell<Vid>>>(type, inserts));
+
+                for(Vid key = 0; key < hotKeys; ++key)
+                    dict->put(key, value);
+
+                seconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                    for(const Vid key: keys[t])
+                        dict->put(key, value);
+                }));
+
+                delete dict; //The values point at one cell on the stack, so they are not deleted
+            }
+
+            report(std::string("put ") + dictTypeName(type) + " (hits " + std::to_string((int) (100 * hitRatio)) + "% of "
+                   + std::to_string(hotKeys) + ")", num_threads, (uint64_t) num_threads * putsPerThread, seconds);
+        }
+    }
+}
+
+void Microbenchmarks::blockedList(const std::vector<unsigned int>& threads, const unsigned int sharedBy, const int pushes, const Vid numLists){
+    typedef BlockedList<Search*> List;
+
+    for(const unsigned int num_threads: threads){
+        const unsigned int sharing(std::max(1u, std::min(sharedBy, num_threads)));
+        const unsigned int groups((num_threads + sharing - 1) / sharing);
+        const std::string setting(" (" + std::to_string(pushes) + " pushes by each of " + std::to_string(sharing) + ")");
+
+        std::vector<double> pushSeconds, walkSeconds;
+        uint64_t read(0);
+
+        for(int run = 0; run < REPEATS; ++run){
+            std::unique_ptr<List[]> lists(new List[(size_t) groups * numLists]);
+            std::vector<uint64_t> items(num_threads, 0);
+
+            pushSeconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                List* const own(lists.get() + (size_t) (t / sharing) * numLists);
+
+                for(Vid list = 0; list < numLists; ++list)
+                    for(int i = 0; i < pushes; ++i)
+                        own[list].push_back(fakeSearch(t));
+            }));
+
+            walkSeconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                List* const own(lists.get() + (size_t) (t / sharing) * numLists);
+                uint64_t count(0);
+
+                for(Vid l = 0; l < numLists; ++l){
+                    List& list(own[l]);
+                    const int size(list.size());
+
+                    if(list.isSmallList(size)){
+                        std::atomic<Search*>* const buffer(list.getSmallBuffer());
+                        for(int i = 0; i < size; ++i)
+                            count += buffer[i].load(std::memory_order_relaxed) != nullptr;
+                    }
+                    else{
+                        auto it(list.getIt(size));
+                        while(it.increment())
+                            count += it.getNext() != nullptr;
+                    }
+                }
+
+                items[t] = count;
+            }));
+
+            read = 0;
+            for(const uint64_t count: items) read += count;
+        }
+
+        report("BlockedList::push_back" + setting, num_threads, (uint64_t) num_threads * numLists * pushes, pushSeconds);
+        report("BlockedList walk" + setting, num_threads, read, walkSeconds);
+    }
+}
+
+void Microbenchmarks::waitTable(const std::vector<unsigned int>& threads, const Vid numCells, const Vid pairsPerThread){
+    //Stand-ins for cells: only their addresses are used, as keys
+    std::vector<uint64_t> cells(std::max((Vid) 1, numCells));
+
+    for(const unsigned int num_threads: threads){
+        std::vector<std::vector<Vid>> picks(num_threads);
+
+        for(unsigned int t = 0; t < num_threads; ++t){
+            CounterRNG rng(SEED, t);
+
+            picks[t].resize(pairsPerThread);
+            for(Vid& pick: picks[t]) pick = (Vid) rng.below(cells.size());
+        }
+
+        std::vector<double> seconds;
+
+        for(int run = 0; run < REPEATS; ++run){
+            AlignedArray<WaitTable> tables(1); //Its buckets are alignas(64)
+            WaitTable& table(tables[0]);
+
+            seconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                std::vector<Search*> parked;
+
+                for(const Vid pick: picks[t]){
+                    table.park(&cells[pick], 0, fakeSearch(t));
+
+                    parked.clear();
+                    table.unparkAll(&cells[pick], 0, parked);
+                }
+            }));
+        }
+
+        report("WaitTable park + unparkAll (" + std::to_string(cells.size()) + " cells)", num_threads,
+               2 * (uint64_t) num_threads * pairsPerThread, seconds);
+    }
+}
+
+void Microbenchmarks::epochs(const std::vector<unsigned int>& threads, const unsigned int advanceEvery, const Vid opsPerThread){
+    for(const unsigned int num_threads: threads){
+        std::vector<double> seconds;
+
+        for(int run = 0; run < REPEATS; ++run){
+            EpochManager manager(num_threads);
+
+            seconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                unsigned int countdown(advanceEvery);
+
+                for(Vid op = 0; op < opsPerThread; ++op){
+                    manager.enter(t);
+
+                    if(advanceEvery && !--countdown){
+                        manager.tryAdvance();
+                        countdown = advanceEvery;
+                    }
+                }
+
+                manager.exit(t);
+            }));
+        }
+
+        report("EpochManager::enter (tryAdvance every " + std::to_string(advanceEvery) + ")", num_threads,
+               (uint64_t) num_threads * opsPerThread, seconds);
+    }
+}
+
+void Microbenchmarks::pendingQueues(const std::vector<unsigned int>& threads, const unsigned int batch, const Vid roundsPerThread){
+    const char* const names[] = {"LockedPendingQueue", "LockFreePendingQueue", "WorkStealingPending"};
+
+    for(const unsigned int num_threads: threads){
+        std::vector<std::vector<Search*>> batches(num_threads);
+
+        for(unsigned int t = 0; t < num_threads; ++t)
+            for(unsigned int i = 0; i < batch; ++i)
+                batches[t].push_back(fakeSearch((uint64_t) t * batch + i));
+
+        for(int queue = 0; queue < 3; ++queue){
+            std::vector<double> seconds;
+
+            for(int run = 0; run < REPEATS; ++run){
+                std::unique_ptr<Pending> pending;
+
+                switch(queue){
+                    case 0:  pending.reset(new LockedPendingQueue); break;
+                    case 1:  pending.reset(new LockFreePendingQueue); break;
+                    default: pending.reset(new WorkStealingPending(num_threads));
+                }
+
+                seconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                    for(Vid round = 0; round < roundsPerThread; ++round){
+                        pending->addPending(&batches[t], t);
+
+                        for(unsigned int i = 0; i < batch; ++i)
+                            pending->get(t);
+                    }
+                }));
+            }
+
+            report(std::string(names[queue]) + " add + get (batches of " + std::to_string(batch) + ")", num_threads,
+                   2 * (uint64_t) num_threads * roundsPerThread * batch, seconds);
+        }
+    }
+}
+
+void Microbenchmarks::stealingQueue(const std::vector<unsigned int>& threads, const DictType type, const double visitedRatio, const Vid numRoots){
+    CSRGraph<Vid> graph(numRoots, std::vector<size_t>(numRoots + 1, 0), std::vector<Vid>());
+    Vid size;
+    const Vid* const vertices(graph.getVerticesArray(size));
+
+    Cell<Vid> done; done.initCell(); done.markComplete();
+
+    for(const unsigned int num_threads: threads){
+        std::vector<double> seconds;
+
+        for(int run = 0; run < REPEATS; ++run){
+            std::unique_ptr<Dictionary<Vid, WeakReference<Cell<Vid>>>> dict(DictionaryFactory::getDictionary<Vid, WeakReference<Cell<Vid>>>(type, numRoots));
+            CounterRNG rng(SEED, run);
+
+            for(Vid v = 0; v < numRoots; ++v)
+                if(rng.uniform() < visitedRatio)
+                    dict->put(v, WeakReference<Cell<Vid>>(&done, done.getAge()));
+
+            UnrootedStealingQueue queue(vertices, size, *dict, num_threads);
+            LockedPendingQueue pending;
+            CancellationToken token;
+            MultiThreadedTarjan scheduler(graph, *dict, num_threads, pending, queue, token);
+            EpochManager manager(num_threads);
+
+            std::vector<Worker> workers;
+            workers.reserve(num_threads);
+
+            for(unsigned int ID = 0; ID < num_threads; ++ID){
+                workers.emplace_back(ID, scheduler, graph, *dict, manager);
+                workers.back().allocateSpareCell();
+            }
+
+            seconds.push_back(timeThreads(num_threads, [&](const unsigned int t){
+                while(queue.next(&workers[t]).get()){;}
+            }));
+
+            for(Worker& worker: workers)
+                worker.cleanUp(); //The cells handed out are still in the dictionary, which is deleted next
+        }
+
+        report(std::string("UnrootedStealingQueue::next ") + dictTypeName(type) + " (" + std::to_string((int) (100 * visitedRatio))
+               + "% visited)", num_threads, numRoots, seconds);
+    }
+}
+
+void Microbenchmarks::runAll(){
+    const std::vector<unsigned int> threads{1, 2, 4, 8};
+    const std::vector<DictType> types{Mutex_Dict, Sharded_Locked, Sharded_SpinLock, TBB_Conc, OpenAddressed, OpenSharded, Cuckoo};
+
+    dictionaries(types, threads, 0.2, 1 << 20);
+    dictionaries(types, threads, 0.9, 64);
+
+    blockedList(threads, 1, 4);
+    blockedList(threads, 8, 4);
+    blockedList(threads, 1, 64);
+
+    waitTable(threads, 1 << 16);
+    waitTable(threads, 4);
+
+    epochs(threads, 1024);
+    epochs(threads, 1);
+
+    pendingQueues(threads, 1);
+    pendingQueues(threads, 32);
+
+    stealingQueue(threads, OpenAddressed, 0);
+    stealingQueue(threads, OpenAddressed, 0.9);
+    stealingQueue(threads, OpenSharded, 0);
+}
@@ -0,0 +1,80 @@
+//
+//  microbenchmarks.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 10/3/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef microbenchmarks_hpp
+#define microbenchmarks_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include "typedefs.h"
+#include "dictionaryFactory.h"
+
+/*Microbenchmarks for the concurrent pieces of the parallel engine, each timed on its own rather than
+ through whole Tarjan runs as benchmarkHashTables in main.cpp does.
+
+ Every benchmark repeats the same operations over a sweep of thread counts, with a knob for how hard the
+ threads contend. The threads are created and handed their inputs before a common start line, so only the
+ operations themselves are timed, and each row is the median of REPEATS runs. Keys and choices are drawn
+ from CounterRNG streams with a fixed seed, so a run does the same work every time.
+
+ Each row gives ops/sec, the throughput of all threads together, and ns/op, the time one thread spends per
+ operation (threads * elapsed / ops). A structure that scales keeps ns/op flat as threads are added*/
+
+class Microbenchmarks{
+
+    const static int REPEATS = 5;
+    const static uint64_t SEED = 2017;
+
+    //Runs body(thread) on num_threads threads once all of them are started and returns the elapsed seconds
+    template <class F>
+    static double timeThreads(unsigned int num_threads, F body);
+
+    //Prints the median of the timings of one configuration
+    static void report(const std::string& name, unsigned int num_threads, uint64_t ops, std::vector<double>& seconds);
+
+public:
+
+    static const char* dictTypeName(DictType type);
+
+    /*Dictionary::put from every thread. hitRatio of the puts hit one of hotKeys keys inserted beforehand, which
+     is what a search does when it reaches a vertex that already has a cell; the others insert keys no one
+     has inserted yet. Fewer hot keys put the threads on the same slots or shards*/
+    static void dictionaries(const std::vector<DictType>& types, const std::vector<unsigned int>& threads,
+                             double hitRatio, Vid hotKeys, Vid putsPerThread = 1 << 20);
+
+    /*BlockedList::push_back, then a walk over every list as SuspensionManager used to do when a cell completed.
+     Each list is shared by sharedBy threads (1 for private lists), which push pushes items each onto a run of
+     numLists lists. The walk reads the small buffer directly and uses the iterator past it*/
+    static void blockedList(const std::vector<unsigned int>& threads, unsigned int sharedBy, int pushes, Vid numLists = 1 << 14);
+
+    /*WaitTable::park followed by unparkAll on one of numCells cells, the suspend and complete paths that replaced
+     BlockedList. Few cells put the threads on the same bucket locks*/
+    static void waitTable(const std::vector<unsigned int>& threads, Vid numCells, Vid pairsPerThread = 1 << 20);
+
+    /*EpochManager::enter, with tryAdvance every advanceEvery calls. EpochManager took the place of ReferenceCounter:
+     enter() is what a worker now pays per quiescent point instead of a reference per edge, and a small
+     advanceEvery has every thread scanning the announcements and racing on the global epoch*/
+    static void epochs(const std::vector<unsigned int>& threads, unsigned int advanceEvery, Vid opsPerThread = 1 << 22);
+
+    /*LockedPendingQueue, LockFreePendingQueue and WorkStealingPending: each thread adds batch searches at a time,
+     as a completed cell resumes its waiters, and takes as many back. Every add and every get is an operation*/
+    static void pendingQueues(const std::vector<unsigned int>& threads, unsigned int batch, Vid roundsPerThread = 1 << 16);
+
+    /*UnrootedStealingQueue::next until the queue runs dry, with numRoots vertices and a dictionary of the given
+     type. visitedRatio of the vertices already have a completed cell, so next() skips them, as it does late in
+     a run. An operation is one vertex handed out or skipped*/
+    static void stealingQueue(const std::vector<unsigned int>& threads, DictType type, double visitedRatio, Vid numRoots = 1 << 21);
+
+    //Every benchmark above at its default sizes and a low and a high contention setting, on 1 to 8 threads
+    static void runAll();
+
+};
+
+#endif /* microbenchmarks_hpp */
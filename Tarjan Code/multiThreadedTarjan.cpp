@@ -25,8 +25,32 @@ SCC_Set* MultiThreadedTarjan::run()
     std::vector<Worker> workers;
     std::vector<std::thread> threads;
     
+    workers.reserve(NUM_THREADS);
+    
     for(int ID = 0; ID < NUM_THREADS; ++ID)
-        workers.emplace_back(ID, *this, graph, dict);
+        workers.emplace_back(ID, *this, graph, dict, epochs, filter);
+    
+    /*Each thread pins itself when it starts. An affinity policy pins every worker to one CPU.
+     Otherwise, in NUMA mode the workers are spread over the nodes in blocks and each is pinned to
+     its node's CPUs. In NUMA mode the stealing queue should be a NumaStealingQueue with one range per
+     node so the workers start their searches from their own node's range*/
+    const Topology& topology(Topology::get());
+    const std::vector<int> placed(topology.placement(affinity, NUM_THREADS));
+    
+    for(Worker& worker: workers){
+        if(placed[worker.ID] >= 0){
+            worker.cpus = {placed[worker.ID]};
+            worker.node = topology.nodeOfCPU(placed[worker.ID]);
+        }
+        else if(NUMA_AWARE){
+            worker.node = topology.nodeOfWorker(worker.ID, NUM_THREADS);
+            worker.cpus = topology.cpusOf(worker.node);
+        }
+    }
+    
+    std::vector<unsigned int> nodeOf;
+    for(Worker& worker: workers) nodeOf.push_back(worker.node);
+    pending.placeWorkers(nodeOf);
     
     for(Worker& worker: workers)
         threads.emplace_back(std::ref(worker));
@@ -37,6 +61,11 @@ SCC_Set* MultiThreadedTarjan::run()
     for(Worker& worker: workers)
         SCCs->insert(SCCs->end(), worker.SCCs.begin(), worker.SCCs.end());
     
+    //Every thread has stopped, so no cell or search can be in use anymore. This also frees
+    //the searches and cells left behind if the run was cancelled
+    for(Worker& worker: workers)
+        worker.cleanUp();
+    
 //    using namespace std::chrono_literals;
 //
 //    std::this_thread::sleep_for(6s);
@@ -64,9 +93,15 @@ Search* MultiThreadedTarjan::getSearch(Worker* worker){
     const long mask(worker->MASK);
     
     while(!done){
+        
+        if(cancelled())
+            return nullptr;
+        
+        //Protects the root cell we get from the queue until we have claimed it
+        epochs.enter(worker->ID);
 
         //First, see if there is a pending Search we can resume
-        search = pending.get();
+        search = pending.get(worker->ID);
         
         if(search) return search;
         
@@ -103,6 +138,7 @@ Search* MultiThreadedTarjan::getSearch(Worker* worker){
         done = (flags.load() == ALL_FLAGS_SET);
         
         if(!done){
+            epochs.exit(worker->ID); //Do not hold up the epoch while we sleep
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
         }
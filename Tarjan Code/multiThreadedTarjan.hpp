@@ -16,6 +16,9 @@
 #include "stealingQueue.hpp"
 #include "worker.hpp"
 #include "utilities.hpp"
+#include "cancellationToken.h"
+#include "epochManager.hpp"
+#include "topology.hpp"
 
 
 class MultiThreadedTarjan{
@@ -26,6 +29,9 @@ private:
     //Constants
     const unsigned int NUM_THREADS;
     const uint64_t ALL_FLAGS_SET;
+    const bool NUMA_AWARE; //Pin each worker to the CPUs of one NUMA node, see run()
+    const Affinity affinity; //Which CPU each worker is pinned to, if any
+    const SubgraphFilter* const filter; //Restricts the run to a subgraph, null for the whole graph
     
     //Data structures
     const Graph<Vid>& graph;
@@ -33,9 +39,12 @@ private:
     SuspensionManager susMgr;
     Pending& pending;
     StealingQueue& cellQueue;
+    CancellationToken& token;
+    EpochManager epochs; //Decides when completed cells can be reused
     
     //Member Variables
     std::atomic<uint64_t> flags{0};
+    std::atomic<bool> aborted{false}; //Set when a worker stops early because the token was cancelled
     
 public:
     
@@ -43,30 +52,43 @@ public:
 
     Search* getSearch(Worker* worker);
     
+    //Polled by the workers. Returns true if the run was cancelled, in which case the worker
+    //should abandon whatever search it is running and exit
+    inline bool cancelled(){
+        if(!token.poll())
+            return false;
+        
+        aborted.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    
+    //False if the run was cancelled before every SCC was found
+    inline bool isComplete(){
+        return !aborted.load();
+    }
+    
 
     inline bool suspend(Worker* worker, Search* const S, Cell<Vid>* conflictCell){
         return susMgr.suspend(*worker, S, conflictCell);
     }
     
     
-    inline void resumeAllBlockedOn(Cell<Vid>* const completeCell, std::vector<Search*>& toResume){
-        BlockedList<Search*>* suspendedList(completeCell->getBlockedList());
+    //The resumed searches are handed to Pending on behalf of worker workerID
+    inline void resumeAllBlockedOn(Cell<Vid>* const completeCell, std::vector<Search*>& toResume, const unsigned int workerID){
+        //No search has parked on the cell
+        if(!completeCell->hasWaiters())
+            return;
         
-        int size(suspendedList->size());
+        toResume.clear();
+        susMgr.bulkUnsuspend(completeCell, toResume);
         
-        if(size){
-            toResume.clear();
-            susMgr.bulkUnsuspend(suspendedList, completeCell, toResume);
-            
-            if(!toResume.empty())
-                pending.addPending(&toResume);
-            
-        }
+        if(!toResume.empty())
+            pending.addPending(&toResume, workerID);
         
     }
   
     
-    MultiThreadedTarjan(const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict, unsigned int num_threads , Pending& _pending, StealingQueue& _queue) : graph(_graph), dict(_dict), NUM_THREADS(num_threads), ALL_FLAGS_SET((1LL << num_threads) - 1), pending(_pending), cellQueue(_queue){
+    MultiThreadedTarjan(const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict, unsigned int num_threads , Pending& _pending, StealingQueue& _queue, CancellationToken& _token, bool numaAware = false, const Affinity& _affinity = Affinity(), const SubgraphFilter* _filter = nullptr) : graph(_graph), dict(_dict), NUM_THREADS(num_threads), ALL_FLAGS_SET((1LL << num_threads) - 1), NUMA_AWARE(numaAware), affinity(_affinity), filter(_filter), pending(_pending), cellQueue(_queue), token(_token), epochs(num_threads){
      ;
     }
    
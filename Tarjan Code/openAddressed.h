@@ -11,43 +11,121 @@
 
 #include "dictionary.h"
 
+/*With 32 bit keys an entry is 16 bytes, so std::atomic<Entry> compiles to a double width compare-and-swap.
+ 64 bit keys make the entry 24 bytes; std::atomic then falls back to libatomic's lock based
+ implementation, which is correct but slower than the 32 bit build*/
+template <class K, class A>
 struct Entry{
-    Entry(const Vid _key, const Vid _age, Cell<Vid>* const _cell ) noexcept : key(_key), age(_age), cell(_cell){;}
+    Entry(const K _key, const A _age, Cell<Vid>* const _cell ) noexcept : key(_key), age(_age), cell(_cell){;}
     Entry( ) noexcept : key(0), age(0), cell(0){;}
 
-    const Vid key, age;
+    const K key;
+    const A age;
     Cell<Vid>* const cell;
 };
 
 
-class OpenAddressedMap : public Dictionary<Vid, WeakReference<Cell<Vid>>>{
+/*Settings shared by a map, or by all shards of a sharded map. A table is valid only while its stamp equals
+ generation; bumping generation empties every table at once, and each table is cleared lazily by its first
+ put afterwards. initPow is the log2 of the capacity a table is (re)allocated with*/
+struct TableGeneration{
+    std::atomic<uint64_t> generation{0};
+    std::atomic<int>      initPow;
+
+    TableGeneration(int _initPow = 11) : initPow(_initPow){;}
+};
+
+template <class K = Vid>
+class OpenAddressedMap : public Dictionary<K, WeakReference<Cell<Vid>>>{
 private:
     
-    std::atomic<Entry>* table;
-    std::atomic<Vid> capacity;
-    std::atomic<Vid> size;
+    //The age is widened to the key's size so that the entry has no padding bytes; compare_exchange
+    //compares the whole object representation, padding included
+    typedef Entry<K, K> TableEntry;
+    
+    std::atomic<TableEntry>* table;
+    std::atomic<K> capacity;
+    std::atomic<K> size;
     std::atomic<int> members;
     
+    TableGeneration  ownGeneration;
+    TableGeneration* shared; //ownGeneration, or the sharded map's
+    std::atomic<uint64_t> stamp; //Generation the table belongs to
+    
+    //The generation only changes in reset(), between runs, so relaxed loads see it. A put that finds the
+    //table current synchronises with the put that prepared it through size
+    inline bool stale() const{
+        return stamp.load(std::memory_order_relaxed) != shared->generation.load(std::memory_order_relaxed);
+    }
+    
+    /*Called with the table to ourselves. Empties the table for the current generation. A table that already
+     has the size the generation asks for is kept and only cleared, and not even that if the last generation
+     put nothing in it (hasEntries false); otherwise it is replaced with a fresh one*/
+    void prepare(const bool hasEntries){
+        const K cap(K(1) << shared->initPow.load());
+        
+        if(table && capacity.load() == cap){
+            if(hasEntries)
+                for(K e = 0; e < cap; ++e)
+                    table[e].store(TableEntry(), std::memory_order_relaxed);
+        }
+        else{
+            delete[] table;
+            
+            capacity.store(cap);
+            table = new std::atomic<TableEntry>[cap]();
+        }
+        
+        stamp.store(shared->generation.load());
+    }
 
 public:
     
-    OpenAddressedMap(int init_pow_2 = 11) : size(1), members(0), capacity(1 << (init_pow_2)){
-        table = new std::atomic<Entry>[1 << (init_pow_2)]();
+    //No memory is allocated before the first put
+    OpenAddressedMap(int init_pow_2 = 11) : table(nullptr), capacity(0), size(1), members(0), ownGeneration(init_pow_2),
+                                            shared(&ownGeneration), stamp(UINT64_MAX){;}
+    
+    //Makes the map follow the generation and initial size of a sharded map. Call before the first put
+    inline void shareGeneration(TableGeneration* generation){
+        shared = generation;
     }
     
-    virtual std::pair<WeakReference<Cell<Vid>>,bool> put(const Vid& key, const WeakReference<Cell<Vid>>& value){
+    //Empties the map in O(1); the table is cleared by the next put. The next table holds about
+    //capacityHint keys before resizing (0 keeps the current size). Not safe while other threads put
+    virtual bool reset(size_t capacityHint = 0){
+        if(capacityHint)
+            ownGeneration.initPow = initialPow(capacityHint);
         
-        Vid currSize;
+        ++ownGeneration.generation;
+        return true;
+    }
+    
+    //log2 of the smallest table that holds keys entries at load factor 1/2, at least 16 entries
+    static int initialPow(size_t keys){
+        int pow(4);
+        while(pow < 8 * (int) sizeof(K) - 2 && (size_t(1) << pow) < 2 * keys + 2) ++pow;
+        return pow;
+    }
+    
+    virtual std::pair<WeakReference<Cell<Vid>>,bool> put(const K& key, const WeakReference<Cell<Vid>>& value){
+        
+        K currSize;
         do{
             
             currSize = size.load(); if(!currSize) continue; //resize in progress
             
-            if(currSize*2 >= capacity){
+            if(currSize*2 >= capacity || stale()){
                 if(!members && size.compare_exchange_weak(currSize, 0)){
                     if(members || size){
                         size += currSize; continue;
                     }
-                    resize(); size = currSize;
+                    
+                    if(stale()){ //First put of this generation
+                        prepare(currSize > 1); size = 1;
+                    }
+                    else{
+                        resize(); size = currSize;
+                    }
                 }
                 else
                     continue;
@@ -56,17 +134,17 @@ public:
             members++;
             currSize = size.load();
             
-            if(currSize*2 >= capacity || !currSize) --members;
+            if(currSize*2 >= capacity || !currSize) --members; //Once current, the table stays so until reset()
             else break;
                 
             
         }while(true);
         
-        Vid cap(capacity), location(getHash(key, cap));
+        K cap(capacity), location(getHash(key, cap));
         
         while(true){
             
-            Entry curr = table[location].load();
+            TableEntry curr = table[location].load();
             if(curr.cell){
 
                 if(curr.key == key){ //Entry exists
@@ -79,7 +157,7 @@ public:
             }
             
         
-            Entry toPut(key, value.age, value.get()); Entry empty;
+            TableEntry toPut(key, value.age, value.get()); TableEntry empty;
              if(table[location].compare_exchange_weak(empty, toPut)){ //successs
                  ++size; --members;
                  return std::make_pair<WeakReference<Cell<Vid>>,bool>(WeakReference<Cell<Vid>>(value.get(), value.age), true);
@@ -89,23 +167,23 @@ public:
     }
  
 
-    inline Vid getHash(const Vid key, const Vid cap){
+    inline K getHash(const K key, const K cap){
         return key % cap;
     }
     
     void resize(){
-        const Vid newCap(capacity*2); const Vid oldCap = capacity;
-        std::atomic<Entry>* newTable = new std::atomic<Entry>[newCap]();
+        const K newCap(capacity*2); const K oldCap = capacity;
+        std::atomic<TableEntry>* newTable = new std::atomic<TableEntry>[newCap]();
        
-        Entry ent;
+        TableEntry ent;
      
-        Vid location;
-        for(int e = 0; e < oldCap; ++e){
-            Entry entry = table[e].load();
+        K location;
+        for(K e = 0; e < oldCap; ++e){
+            TableEntry entry = table[e].load();
             if(entry.cell){
                 location = getHash(entry.key, newCap);
                 while(true){
-                    Entry curr = newTable[location].load();
+                    TableEntry curr = newTable[location].load();
                     if(curr.cell)
                         location = (1 + location) % newCap;
                     else{
@@ -130,12 +208,12 @@ public:
     
     virtual ~OpenAddressedMap(){delete[] table;}
     
-    virtual std::vector<Vid>* getKeys(){return nullptr;};
+    virtual std::vector<K>* getKeys(){return nullptr;};
     
     virtual std::vector<WeakReference<Cell<Vid>>>* getValues(){return nullptr;};
     
     //An implementation does not need to support this either
-    virtual bool contains(const Vid& key){return 0;}
+    virtual bool contains(const K& key){return 0;}
     
     virtual void deleteValues(){;}
     
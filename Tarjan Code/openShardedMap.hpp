@@ -13,48 +13,80 @@
 //#include "tbb_concurrent_map.h"
 #include "cuckooDict.h"
 
-class OpenAddressedShardedMap   : public Dictionary<Vid, WeakReference<Cell<Vid>>>{
+template <class K = Vid>
+class OpenAddressedShardedMap   : public Dictionary<K, WeakReference<Cell<Vid>>>{
 private:
     
     const static int BITS = 12;
     const static int SHARDS = 2 << BITS;
-    OpenAddressedMap shard[SHARDS];
+    OpenAddressedMap<K> shard[SHARDS];
+    TableGeneration generation;
+    
+    //Keys expected per shard for a capacity hint, with some slack since keys do not spread evenly
+    static int shardPow(size_t capacityHint){
+        return OpenAddressedMap<K>::initialPow(capacityHint / SHARDS + capacityHint / (4 * SHARDS) + 8);
+    }
     
    
 public:
     
-  
+    /*Shards allocate their tables on their first put, so a run only pays for the shards it touches.
+     capacityHint is the number of keys expected, e.g. the number of vertices; shards are sized for an even
+     share of it. Without a hint every shard starts at 2^11 entries*/
+    OpenAddressedShardedMap(size_t capacityHint = 0) : generation(capacityHint ? shardPow(capacityHint) : 11){
+        for(int s = 0; s < SHARDS; ++s)
+            shard[s].shareGeneration(&generation);
+    }
     
-    virtual std::pair<WeakReference<Cell<Vid>>,bool> put(const Vid& key, const WeakReference<Cell<Vid>>& value){
+    //Empties the map in O(1) so it can be reused by another run; each shard is cleared by its next put.
+    //Not safe while other threads put
+    virtual bool reset(size_t capacityHint = 0){
+        if(capacityHint)
+            generation.initPow = shardPow(capacityHint);
+        
+        ++generation.generation;
+        return true;
+    }
+    
+    virtual std::pair<WeakReference<Cell<Vid>>,bool> put(const K& key, const WeakReference<Cell<Vid>>& value){
         
         //Inserts a value into the hashtable if the key did no already exist in the dictionary.
         //Returns true if and only if the insertion is successful
-            Vid _key = getHash(key);
-            Vid key1 = _key & (SHARDS - 1);
-            Vid key2 = _key >> BITS;
+            K _key = getHash(key);
+            K key1 = _key & (SHARDS - 1);
+            K key2 = _key >> BITS;
         
         
             return shard[key1].put(key2,value);
 
     }
     
-    inline Vid getHash(Vid x) {
+    //The hashes are bijective so distinct keys never collide before they are split into shard and slot
+    static inline uint32_t getHash(uint32_t x) {
         x = ((x >> 16) ^ x) * 0x45d9f3b;
         x = ((x >> 16) ^ x) * 0x45d9f3b;
         x = (x >> 16) ^ x;
         return x;
     }
+    
+    //64 bit finalizer (splitmix64). Both halves of the key affect the low bits used to pick the shard
+    static inline uint64_t getHash(uint64_t x) {
+        x = ((x >> 30) ^ x) * 0xbf58476d1ce4e5b9ULL;
+        x = ((x >> 27) ^ x) * 0x94d049bb133111ebULL;
+        x = (x >> 31) ^ x;
+        return x;
+    }
 
 
     
     virtual ~OpenAddressedShardedMap(){}
     
-    virtual std::vector<Vid>* getKeys(){return nullptr;};
+    virtual std::vector<K>* getKeys(){return nullptr;};
     
     virtual std::vector<WeakReference<Cell<Vid>>>* getValues(){return nullptr;};
     
     //An implementation does not need to support this either
-    virtual bool contains(const Vid& key){return 0;}
+    virtual bool contains(const K& key){return 0;}
     
     virtual void deleteValues(){;}
     
@@ -0,0 +1,41 @@
+//
+//  parallelFor.h
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/30/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef parallelFor_h
+#define parallelFor_h
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include "typedefs.h"
+
+/*Runs body(begin, end) over num_threads contiguous slices of 0 .. n-1 and returns once all are done.
+ The calling thread takes the last slice. Used by the graph preprocessing passes, which split their
+ vertices or edges evenly and need no load balancing*/
+
+template <class F>
+void parallelFor(const Vid n, Vid num_threads, F body){
+    num_threads = std::max((Vid) 1, std::min(num_threads, n));
+
+    std::vector<std::thread> threads;
+    const Vid slice(n / num_threads), extra(n % num_threads);
+    Vid begin(0);
+
+    for(Vid t = 0; t < num_threads; ++t){
+        const Vid end(begin + slice + (t < extra));
+
+        if(t + 1 == num_threads) body(begin, end);
+        else threads.emplace_back(body, begin, end);
+
+        begin = end;
+    }
+
+    for(std::thread& thread: threads) thread.join();
+}
+
+#endif /* parallelFor_h */
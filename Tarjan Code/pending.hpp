@@ -15,6 +15,8 @@
 #include <deque>
 //#include "tbb/concurrent_queue.h"
 #include "ConcurrentQueue.h"
+#include "workStealingDeque.hpp"
+#include "alignedArray.h"
 
 class Pending{
     
@@ -29,6 +31,20 @@ public:
     
     virtual bool isDone() = 0;
     
+    //Versions called by the workers, which say which worker is calling. Queues that do not
+    //care where a search is resumed can ignore the ID
+    virtual void addPending(std::vector<Search*>* const toAdd, const unsigned int){
+        addPending(toAdd);
+    }
+    
+    virtual Search* get(const unsigned int){
+        return get();
+    }
+    
+    //Called before the workers start with the NUMA node each worker runs on, for queues that prefer to
+    //hand a search to a worker on the node it was resumed on
+    virtual void placeWorkers(const std::vector<unsigned int>&){;}
+    
     virtual ~Pending(){;}
     
 };
@@ -133,7 +149,104 @@ class LockFreePendingQueue : public Pending{
 };
 
 
+/* One Chase-Lev deque per worker. A worker that completes a cell pushes the searches it resumes onto
+ its own deque and pops them back LIFO, while their stacks are likely still in its cache. Idle workers
+ steal the oldest searches from the other deques, starting with the next worker's, so thieves spread out.
+ Once the workers are placed (see placeWorkers()), thieves try the workers on their own NUMA node first, so
+ a resumed search, whose stack and cells were allocated on the node, tends to stay there.
+ 
+ Searches added without a worker ID (not done by the engine itself) go into a shared queue, since only
+ the owner may push onto a deque
+ */
 
+class WorkStealingPending : public Pending{
+    
+    const unsigned int NUM_THREADS;
+    AlignedArray<WorkStealingDeque<Search*>> deques; //Each deque keeps top and bottom on cache lines of their own
+    moodycamel::ConcurrentQueue<Search*> shared;
+    
+    //victims[ID * (NUM_THREADS - 1) + i] is the i-th deque worker ID steals from
+    std::vector<unsigned int> victims;
+    
+public:
+    
+    //Until placeWorkers() is called, worker ID steals from ID + 1, ID + 2, ... wrapping around
+    WorkStealingPending(const unsigned int num_threads) : NUM_THREADS(num_threads), deques(num_threads){
+        placeWorkers(std::vector<unsigned int>(num_threads, 0));
+    }
+    
+    //Same order as above, but the workers on the thief's own node come before all others
+    void placeWorkers(const std::vector<unsigned int>& nodeOf){
+        victims.clear();
+        
+        for(unsigned int ID = 0; ID < NUM_THREADS; ++ID)
+            for(const bool local: {true, false})
+                for(unsigned int i = 1; i < NUM_THREADS; ++i){
+                    const unsigned int victim((ID + i) % NUM_THREADS);
+                    
+                    if((nodeOf[victim] == nodeOf[ID]) == local)
+                        victims.push_back(victim);
+                }
+    }
+    
+    inline void addPending(Search* search){
+        shared.enqueue(search);
+    }
+    
+    inline void addPending(std::vector<Search*>* const toAdd){
+        for(Search* search: *toAdd)
+            if(search)
+                shared.enqueue(search);
+    }
+    
+    inline void addPending(std::vector<Search*>* const toAdd, const unsigned int workerID){
+        WorkStealingDeque<Search*>& local(deques[workerID]);
+        
+        for(Search* search: *toAdd)
+            if(search)
+                local.push(search);
+    }
+    
+    Search* get(){
+        Search* toReturn;
+        
+        if(shared.try_dequeue(toReturn))
+            return toReturn;
+        
+        for(unsigned int victim = 0; victim < NUM_THREADS; ++victim)
+            if((toReturn = deques[victim].steal()))
+                return toReturn;
+        
+        return nullptr;
+    }
+    
+    Search* get(const unsigned int workerID){
+        Search* toReturn(deques[workerID].pop());
+        
+        if(toReturn || shared.try_dequeue(toReturn))
+            return toReturn;
+        
+        const unsigned int* const order(victims.data() + (size_t) workerID * (NUM_THREADS - 1));
+        
+        for(unsigned int i = 0; i + 1 < NUM_THREADS; ++i)
+            if((toReturn = deques[order[i]].steal()))
+                return toReturn;
+        
+        return nullptr;
+    }
+    
+    bool isDone(){
+        if(shared.size_approx() != 0)
+            return false;
+        
+        for(unsigned int ID = 0; ID < NUM_THREADS; ++ID)
+            if(!deques[ID].empty())
+                return false;
+        
+        return true;
+    }
+    
+};
 
 
 #endif /* pending_hpp */
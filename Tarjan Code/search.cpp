@@ -13,7 +13,7 @@
                               /*******************   Constructor and Destructor   ************/
 
 
-Search::Search() : cellCount(0), age(0), cellBlockedOn(nullptr){
+Search::Search() : cellCount(0), age(0), cellBlockedOn(nullptr), hint(BlockingHint{nullptr, 0}){
 }
 
 Search::~Search(){ }
@@ -76,16 +76,13 @@ void Search::refreshCellCount(){
         /*Transfer cells from source to destination */
 
 
-void Search::transferCells(Search* const src, Search* const dest, Cell<Vid>* const conflictCell){
+void Search::transferCells(Search* const src, Search* const dest, Cell<Vid>* const conflictCell, WaitTable& waiters){
 
     TarjanStack &  srcTarjanStack  = src->tarjanStack;
     ControlStack& srcControlStack  = src->controlStack;
     
-    //We use a reverse iterator since we are starting from the top of the stack
-    auto reverseIt = srcTarjanStack.rbegin();
-    
-    Cell<Vid>* next = *reverseIt; Vid minRank(next->rank);
-    bool reachedCC(next == conflictCell);
+    Idx minRank(srcTarjanStack.back()->rank);
+    bool reachedCC(false);
     
 
     /* Remove cells from src's tarjanStack, starting from the top and proceeding until
@@ -93,48 +90,44 @@ void Search::transferCells(Search* const src, Search* const dest, Cell<Vid>* con
      b) The latest cell transferred has rank no greater than the minimum rank of the cells transferred so far
      */
     
-    while(!reachedCC || next->index > minRank){
-        next = *(++reverseIt); //Increment iterator and get the next element
-        minRank = std::min(minRank, next->rank);
-        if(next == conflictCell) reachedCC = true;
-    }
+    auto lastPosition = srcTarjanStack.findFromTop([&](Cell<Vid>* const cell){
+        minRank = std::min(minRank, cell->rank);
+        if(cell == conflictCell) reachedCC = true;
+        
+        return reachedCC && cell->index <= minRank;
+    });
     
     //Transfer the relevent cells from src's tarjan stack to dest's tarjan stack
     
-    Cell<Vid>* const last(next);
-    
-    Vid delta(dest->cellCount - last->index);
+    Cell<Vid>* const last(srcTarjanStack.at(lastPosition));
     
-    //Carry out the transfer
-    dest->tarjanStack.insert(dest->tarjanStack.end(), (reverseIt+1).base(), srcTarjanStack.end());
+    Idx delta(dest->cellCount - last->index);
     
     //adjust the index and ranks and status of the transferred cells
     //to be compatible with the cell's new tarjanStack
-    for(auto it = (reverseIt+1).base(); it != srcTarjanStack.end(); ++it)
-        (*it)->transfer(delta, dest);
-    
-    //Erase the cells transferred to dest from src's tarjan stack
-    //Using stl functions to accomplish this may be faster than a loop hence we use the
-    //erase() function
-    srcTarjanStack.erase((reverseIt+1).base(), srcTarjanStack.end());
-    
-    auto rit = srcControlStack.rbegin();
+    srcTarjanStack.forEachFrom(lastPosition, [&](Cell<Vid>* const cell){
+        cell->transfer(delta, dest);
+    });
     
-    while(*rit != last) ++rit;
+    //Carry out the transfer. Whole segments are relinked rather than copied
+    srcTarjanStack.moveSuffixTo(lastPosition, dest->tarjanStack);
     
     //Transfer cells from src control stack to destination control stack
     //starting from the controlStack's top and proceeding to the last cell transferred
     
-    dest->controlStack.insert(dest->controlStack.end(), (rit+1).base(), srcControlStack.end());
+    auto controlPosition = srcControlStack.findFromTop([last](Cell<Vid>* const cell){
+        return cell == last;
+    });
     
-    srcControlStack.erase((rit+1).base(), srcControlStack.end());
+    srcControlStack.moveSuffixTo(controlPosition, dest->controlStack);
     
     
     //transfered to dest
     //Src now blocks on the deepest cell in the tarjan stack that we transfered to dest
     if(!srcTarjanStack.empty()){
         src->suspendOn(last);
-        last->blockSearch(src);
+        last->markWaiters();
+        waiters.park(last, last->getAge(), src);
         src->refreshCellCount();
     }
     else
@@ -150,15 +143,17 @@ void Search::printStacks(){
     
     std::cout<< "Tarjan stack " <<std::endl;
     
-    for(Cell<Vid>* cell: tarjanStack)
+    tarjanStack.forEach([](Cell<Vid>* cell){
         std::cout << cell->index << " ";
+    });
     
     std::cout<< std::endl;
     
     std::cout<< "control stack " <<std::endl;
     
-    for(Cell<Vid>* cell: controlStack)
+    controlStack.forEach([](Cell<Vid>* cell){
         std::cout << cell->index << " ";
+    });
     
     std::cout << "\ncell count: " << this->cellCount;
     
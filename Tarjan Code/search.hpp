@@ -15,6 +15,8 @@
 #include "directedHashGraph.h"
 #include "mutexDict.h"
 #include "typedefs.h"
+#include "segmentedStack.hpp"
+#include "waitTable.hpp"
 
 typedef std::atomic<Search*> Status;
 
@@ -22,22 +24,32 @@ template <class V>
 class Cell;
 class MultiThreadedTarjan;
 
-typedef std::vector<Cell<Vid>*> TarjanStack;
-typedef std::vector<Cell<Vid>*> ControlStack;
+//Segmented so that transfers between searches splice stack suffixes instead of copying them
+typedef SegmentedStack<Cell<Vid>*> TarjanStack;
+typedef SegmentedStack<Cell<Vid>*> ControlStack;
 
 
+/*Shortcut in the forest of blocked searches: target lies on the search's blocking path. Only valid while
+ version equals the SuspensionManager's blocking version, see SuspensionManager::reaches()*/
+struct BlockingHint{
+    Search*  target;
+    uint64_t version;
+};
+
 struct Search {
     
 private:
     std::atomic<Cell<Vid>*> cellBlockedOn;
     TarjanStack  tarjanStack;
     ControlStack controlStack; //Simulates the call stack to avoid recursion    
-    Vid cellCount;
+    Idx cellCount;
 
     
 public:
 
-    std::atomic<Vid> age;
+    std::atomic<Age> age;
+    
+    std::atomic<BlockingHint> hint;
 
     Search();
 
@@ -121,7 +133,7 @@ public:
         return controlStack.empty();
     }
     
-    static void transferCells(Search* const src, Search* const dest, Cell<Vid>* const conflictCell);
+    static void transferCells(Search* const src, Search* const dest, Cell<Vid>* const conflictCell, WaitTable& waiters);
 
     //methods for testing the class
     static void testCellTransfer(const Graph<Vid>& _graph, Dictionary<Vid, Cell<Vid>*>& _dict);
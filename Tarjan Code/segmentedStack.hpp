@@ -0,0 +1,196 @@
+//
+//  segmentedStack.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/27/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef segmentedStack_hpp
+#define segmentedStack_hpp
+
+#include <stddef.h>
+
+/** Stack built from linked fixed size segments, used for a search's tarjan and control stacks.
+
+ When searches collide, a suffix of one search's stacks moves onto another's (see Search::transferCells).
+ With a vector that means copying the suffix and erasing it from the source. Here the segments above the one
+ the suffix starts in are relinked onto the destination, so a move costs at most SEGMENT element copies plus
+ one step per segment, however long the suffix is.
+
+ Segments are not kept full: a spliced run of segments sits on top of the destination's partly filled top
+ segment. No segment in the stack is ever empty. One emptied segment is kept as a spare so that a stack
+ oscillating around a segment boundary does not allocate.
+
+ Not thread safe; a stack is only used by the worker running its search.
+ */
+
+template <class T, unsigned SEGMENT = 128>
+class SegmentedStack{
+
+    struct Segment{
+        Segment* below;
+        Segment* above;
+        unsigned used;
+        T items[SEGMENT];
+    };
+
+    Segment* top;
+    Segment* spare;
+    size_t   count;
+
+    inline Segment* newSegment(){
+        Segment* segment(spare ? spare : new Segment);
+        spare = nullptr;
+
+        segment->above = nullptr; segment->used = 0;
+        return segment;
+    }
+
+    inline void recycle(Segment* const segment){
+        if(spare) delete spare;
+        spare = segment;
+    }
+
+    //Removes the top segment, which the caller has emptied
+    inline void dropTop(){
+        Segment* const empty(top);
+
+        top = top->below;
+        if(top) top->above = nullptr;
+
+        recycle(empty);
+    }
+
+public:
+
+    //An element of the stack, as found by findFromTop()
+    struct Position{
+        Segment* segment;
+        unsigned offset;
+    };
+
+    SegmentedStack() : top(nullptr), spare(nullptr), count(0){;}
+
+    SegmentedStack(const SegmentedStack&) = delete;
+    SegmentedStack& operator=(const SegmentedStack&) = delete;
+
+    ~SegmentedStack(){
+        while(top){
+            Segment* const below(top->below);
+            delete top; top = below;
+        }
+
+        delete spare;
+    }
+
+    inline void push_back(const T& item){
+        if(!top || top->used == SEGMENT){
+            Segment* const segment(newSegment());
+
+            segment->below = top;
+            if(top) top->above = segment;
+            top = segment;
+        }
+
+        top->items[top->used++] = item; ++count;
+    }
+
+    inline void pop_back(){
+        --count;
+        if(!--top->used) dropTop();
+    }
+
+    inline T& back(){
+        return top->items[top->used - 1];
+    }
+
+    inline bool empty() const{
+        return !count;
+    }
+
+    inline size_t size() const{
+        return count;
+    }
+
+    inline T& at(const Position& position){
+        return position.segment->items[position.offset];
+    }
+
+    /*Visits the elements from the top down until found returns true and returns that element's position.
+     Pre: found returns true for some element*/
+    template <class F>
+    Position findFromTop(F found){
+        for(Segment* segment = top; segment; segment = segment->below)
+            for(unsigned offset = segment->used; offset-- > 0;)
+                if(found(segment->items[offset]))
+                    return Position{segment, offset};
+
+        return Position{nullptr, 0};
+    }
+
+    //Visits the elements from position up to the top, in stack order
+    template <class F>
+    void forEachFrom(Position position, F visit){
+        for(Segment* segment = position.segment; segment; segment = segment->above, position.offset = 0)
+            for(unsigned offset = position.offset; offset < segment->used; ++offset)
+                visit(segment->items[offset]);
+    }
+
+    //Visits every element from the bottom up
+    template <class F>
+    void forEach(F visit){
+        if(!top) return;
+
+        Segment* bottom(top);
+        while(bottom->below) bottom = bottom->below;
+
+        forEachFrom(Position{bottom, 0}, visit);
+    }
+
+    //Removes the elements from position up to the top
+    void truncate(const Position& position){
+        Segment* const segment(position.segment);
+
+        while(top != segment){
+            count -= top->used;
+            dropTop();
+        }
+
+        count -= segment->used - position.offset;
+        segment->used = position.offset;
+
+        if(!segment->used) dropTop();
+    }
+
+    /*Moves the elements from position up to the top onto dest, keeping their order. The elements of the
+     segment position lies in are copied, the segments above it are relinked*/
+    void moveSuffixTo(const Position& position, SegmentedStack& dest){
+        Segment* const segment(position.segment);
+
+        for(unsigned offset = position.offset; offset < segment->used; ++offset)
+            dest.push_back(segment->items[offset]);
+
+        count -= segment->used - position.offset;
+        segment->used = position.offset;
+
+        if(Segment* const first = segment->above){
+            Segment* const last(top);
+
+            for(Segment* moved = first; moved; moved = moved->above){
+                count -= moved->used; dest.count += moved->used;
+            }
+
+            segment->above = nullptr; top = segment;
+
+            first->below = dest.top;
+            if(dest.top) dest.top->above = first;
+            dest.top = last;
+        }
+
+        if(!segment->used) dropTop();
+    }
+
+};
+
+#endif /* segmentedStack_hpp */
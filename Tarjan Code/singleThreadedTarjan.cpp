@@ -17,10 +17,15 @@ const char SingleCell::NEW_CELL = 0, SingleCell::ON_STACK = 1, SingleCell::COMPL
 SCC_Set* SingleThreadedTarjan::run(){
 
     Vid size, vertex;
-    Vid* verts = graph.getVerticesArray(size);
+    const Vid* verts = filter ? filter->getVertices(size) : nullptr;
+    
+    if(!verts) //Scan the whole graph, skipping vertices outside the subgraph
+        verts = graph.getVerticesArray(size);
 
-    for(int v = 0; v < size; ++v){
+    for(Vid v = 0; v < size; ++v){
         vertex =  verts[v];
+        if(filter && !filter->hasVertex(vertex)) continue;
+        
         if(!lookup.count(vertex)){
             SingleCell* root = &lookup[vertex];
             root->vertex = vertex;
@@ -15,6 +15,7 @@
 #include "typedefs.h"
 #include <algorithm>
 #include "graph.h"
+#include "subgraphFilter.h"
 #include <vector>
 
 
@@ -33,13 +34,13 @@ struct SingleCell{
     
     Vid vertex; //What vertex is the cell associated with?
     
-    Vid index, rank;
+    Idx index, rank;
     
     short status = NEW_CELL;
 
     std::vector<SingleCell*> unassignedNeighbors;
     
-    inline void updateRank(Vid update){
+    inline void updateRank(Idx update){
         this->rank = std::min(update, this->rank);
     }
     
@@ -60,14 +61,16 @@ private:
     std::unordered_map<Vid, SingleCell> lookup;
     std::vector<SingleCell*> controlStack;
     std::vector<SingleCell*> tarjanStack;
-    Vid cellCount = 0;
+    Idx cellCount = 0;
     SCC_Set* SCCs = new SCC_Set;
     const Graph<Vid>& graph;
+    const SubgraphFilter* const filter; //Null unless the run is restricted to a subgraph
+    std::vector<Vid> decoded; //Successors of the cell being conquered, for graphs that decode them, see Graph::decodeNeighbors
     
     
     //Methods
     
-    SingleThreadedTarjan(const Graph<Vid>& _graph) : graph(_graph){;}
+    SingleThreadedTarjan(const Graph<Vid>& _graph, const SubgraphFilter* _filter = nullptr) : graph(_graph), filter(_filter){;}
     ~SingleThreadedTarjan();
 
     void conquer(SingleCell* cell){
@@ -75,7 +78,13 @@ private:
         cell->index  = cell->rank = cellCount++;
         cell->status = SingleCell::ON_STACK;
         
-        for(auto& vertex: graph.getNeighborsVector(cell->vertex)){
+        Vid degree;
+        const Vid* const succs(graph.decodeNeighbors(cell->vertex, degree, decoded));
+        
+        for(Vid e = 0; e < degree; ++e){
+            const Vid vertex(succs[e]);
+            
+            if(filter && !filter->hasEdge(cell->vertex, vertex)) continue; //The edge leaves the subgraph
             
             //Vertex already seen
             if(lookup.count(vertex)){
@@ -18,21 +18,77 @@ UnrootedStealingQueue::~UnrootedStealingQueue(){
     
 }
 
+WeakReference<Cell<Vid>> StealingQueue::discover(Worker* const worker, Dictionary<Vid, WeakReference<Cell<Vid>>>& dict, const Vid vertex){
+    Cell<Vid>* const toPut(worker->spareCell);
+    toPut->vertex = vertex;
+    auto status = dict.put(vertex, WeakReference<Cell<Vid>>(toPut, toPut->getAge()));
+    
+    if(status.second) //If we used up the cell, allocate a replacement
+        worker->allocateSpareCell();
+    
+    if(status.first.get()->isNew(status.first.age))
+        return status.first;
+    
+    return nullWeakReference;
+}
+
 WeakReference<Cell<Vid>>  UnrootedStealingQueue::next(Worker* const worker){
     Vid next(index++);
     
     while(next < ttlCells){
-        Cell<Vid>* const toPut(worker->spareCell);
-        toPut->vertex = vertices[next];
-        auto status = dict.put(vertices[next], WeakReference<Cell<Vid>>(toPut, toPut->age));
-        
-        if(status.second) //If we used up the cell, allocate a replacement
-            worker->allocateSpareCell();
-        
-        if(status.first.get()->isNew(status.first.age))
-                return status.first;
+        if(inSubgraph(vertices[next])){
+            WeakReference<Cell<Vid>> root(discover(worker, dict, vertices[next]));
+            
+            if(root.get())
+                return root;
+        }
 
         next = index++;
     }
     return nullWeakReference; //All done with cells
 }
+
+NumaStealingQueue::NumaStealingQueue(const Vid* const toExplore, Vid size, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict, unsigned int numNodes) : vertices(toExplore), NUM_NODES(std::max(1u, numNodes)), partitions(std::max(1u, numNodes)), dict(_dict){
+    
+    for(unsigned int node = 0; node < NUM_NODES; ++node){
+        partitions[node].begin = Vid((uint64_t) size * node / NUM_NODES);
+        partitions[node].end   = Vid((uint64_t) size * (node + 1) / NUM_NODES);
+        partitions[node].index = partitions[node].begin;
+    }
+}
+
+WeakReference<Cell<Vid>> NumaStealingQueue::next(Worker* const worker){
+    const unsigned int home(worker->getNode() % NUM_NODES);
+    
+    for(unsigned int i = 0; i < NUM_NODES; ++i){
+        Partition& partition(partitions[(home + i) % NUM_NODES]);
+        
+        //Checking first keeps idle workers from bumping the counters of used up ranges
+        while(partition.index.load(std::memory_order_relaxed) < partition.end){
+            const Vid next(partition.index++);
+            if(next >= partition.end) break;
+            
+            if(!inSubgraph(vertices[next])) continue;
+            
+            WeakReference<Cell<Vid>> root(discover(worker, dict, vertices[next]));
+            
+            if(root.get())
+                return root;
+        }
+    }
+    
+    return nullWeakReference; //All done with cells
+}
+
+bool NumaStealingQueue::isEmpty(){
+    for(unsigned int node = 0; node < NUM_NODES; ++node)
+        if(partitions[node].index.load() < partitions[node].end)
+            return false;
+    
+    return true;
+}
+
+void NumaStealingQueue::clear(){
+    for(unsigned int node = 0; node < NUM_NODES; ++node)
+        partitions[node].index = partitions[node].begin;
+}
@@ -13,6 +13,8 @@
 #include <iostream>
 #include "cell.h"
 #include "worker.hpp"
+#include "subgraphFilter.h"
+#include "alignedArray.h"
 
 class StealingQueue{
 
@@ -25,6 +27,25 @@ public:
     virtual bool isEmpty() = 0;
     
     virtual void clear() = 0;
+    
+    //Only vertices in the filter's subgraph are handed out as roots
+    inline void restrictTo(const SubgraphFilter* const _filter){
+        filter = _filter;
+    }
+    
+    virtual ~StealingQueue(){;}
+    
+protected:
+    
+    const SubgraphFilter* filter = nullptr;
+    
+    inline bool inSubgraph(const Vid vertex){
+        return !filter || filter->hasVertex(vertex);
+    }
+    
+    //Puts a cell for vertex in the dictionary, using the worker's spare cell if the vertex is not there yet.
+    //Returns the vertex's cell if no search has claimed or completed it yet, otherwise a null reference
+    static WeakReference<Cell<Vid>> discover(Worker* const worker, Dictionary<Vid, WeakReference<Cell<Vid>>>& dict, const Vid vertex);
 
 };
 
@@ -54,7 +75,7 @@ public:
         index = 0; 
     }
     
-    inline void bulkInsert(std::vector<Cell<Vid>*>& cells){
+    inline void bulkInsert(std::vector<Cell<Vid>*>&){
         
         throw std::exception();
 
@@ -63,8 +84,42 @@ public:
     
 };
 
-
-
+/* Used in NUMA mode. The vertices are split into one contiguous range per node. A worker starts new
+ searches from its own node's range first, so the cells of its roots (and their neighborhoods, which the
+ worker allocates as it explores) end up in node local memory. Once the local range is used up, the
+ worker steals roots from the other nodes' ranges, nearest node number first
+ */
+class NumaStealingQueue : public StealingQueue{
+private:
+    
+    struct alignas(64) Partition{
+        std::atomic<Vid> index;
+        Vid begin;
+        Vid end;
+    };
+    
+    const Vid* const vertices;
+    const unsigned int NUM_NODES;
+    AlignedArray<Partition> partitions;
+    Dictionary<Vid, WeakReference<Cell<Vid>>>& dict;
+    
+public:
+    
+    NumaStealingQueue(const Vid* const toExplore, Vid size, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict, unsigned int numNodes);
+    
+    WeakReference<Cell<Vid>> next(Worker* const worker);
+    
+    bool isEmpty();
+    
+    void clear();
+    
+    inline void bulkInsert(std::vector<Cell<Vid>*>&){
+        
+        throw std::exception();
+        
+    }
+    
+};
 
 
 
@@ -0,0 +1,123 @@
+//
+//  subgraphFilter.h
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/21/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef subgraphFilter_h
+#define subgraphFilter_h
+
+#include <vector>
+#include <functional>
+#include <unordered_set>
+#include "typedefs.h"
+
+/** Restricts an SCC run to a subgraph without copying the graph. Only vertices the filter contains are used
+ as roots, and an edge is only followed if its head is in the subgraph and, if an edge filter is set, the edge
+ filter accepts it. So the run finds the SCCs of the subgraph induced by the vertices (minus filtered edges).
+
+ A filter that knows its vertices can return them from getVertices(); the run then starts its searches from
+ that list instead of scanning every vertex of the graph.
+ */
+
+class SubgraphFilter{
+
+protected:
+
+    std::function<bool(Vid, Vid)> edgeFilter;
+
+public:
+
+    virtual bool hasVertex(const Vid vertex) const = 0;
+
+    //Pre: from is in the subgraph
+    inline bool hasEdge(const Vid from, const Vid to) const{
+        return hasVertex(to) && (!edgeFilter || edgeFilter(from, to));
+    }
+
+    //Only edges for which filter returns true are followed
+    inline void setEdgeFilter(const std::function<bool(Vid, Vid)>& filter){
+        edgeFilter = filter;
+    }
+
+    //The vertices of the subgraph, or null if the filter cannot list them
+    virtual const Vid* getVertices(Vid& size) const{
+        size = 0; return nullptr;
+    }
+
+    virtual ~SubgraphFilter(){;}
+
+};
+
+//One bit per vertex id, for subgraphs given as a set of states
+class VertexBitmap : public SubgraphFilter{
+
+    std::vector<uint64_t> words;
+
+public:
+
+    VertexBitmap(){;}
+
+    template <class Iterator>
+    VertexBitmap(Iterator first, Iterator last){
+        for(; first != last; ++first)
+            insert(*first);
+    }
+
+    inline void insert(const Vid vertex){
+        if((vertex >> 6) >= words.size())
+            words.resize((vertex >> 6) + 1, 0);
+
+        words[vertex >> 6] |= 1ULL << (vertex & 63);
+    }
+
+    inline void erase(const Vid vertex){
+        if((vertex >> 6) < words.size())
+            words[vertex >> 6] &= ~(1ULL << (vertex & 63));
+    }
+
+    inline bool hasVertex(const Vid vertex) const{
+        return (vertex >> 6) < words.size() && ((words[vertex >> 6] >> (vertex & 63)) & 1);
+    }
+
+};
+
+//Subgraph of the vertices for which a predicate holds
+class VertexPredicate : public SubgraphFilter{
+
+    std::function<bool(Vid)> predicate;
+
+public:
+
+    VertexPredicate(const std::function<bool(Vid)>& _predicate) : predicate(_predicate){;}
+
+    inline bool hasVertex(const Vid vertex) const{
+        return predicate(vertex);
+    }
+
+};
+
+//An explicit list of vertices, e.g. one previous component. Searches start from the list only
+class VertexList : public SubgraphFilter{
+
+    std::vector<Vid> vertices;
+    std::unordered_set<Vid> members;
+
+public:
+
+    VertexList(const std::vector<Vid>& _vertices) : vertices(_vertices), members(_vertices.begin(), _vertices.end()){;}
+
+    inline bool hasVertex(const Vid vertex) const{
+        return members.count(vertex) > 0;
+    }
+
+    const Vid* getVertices(Vid& size) const{
+        size = (Vid) vertices.size();
+        return vertices.data();
+    }
+
+};
+
+#endif /* subgraphFilter_h */
@@ -68,6 +68,12 @@
  
  
  
+           Fast check: walking the whole path on every suspension costs time proportional to the number of searches
+           blocked behind one another, so with many searches piled up behind one search it becomes quadratic.
+           Before the two passes we therefore only ask whether the path from S0 reaches Sn at all, see reaches().
+           That walk follows path compressed shortcuts and is usually constant time. Only if it reaches Sn do we
+           build and verify the path as described above.
+ 
            a-->b-->c-->a
  
  
@@ -94,9 +100,11 @@ Note (*) On the second pass, we must check if Ci is still on Si's stack before v
 
 bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* const conflictCell){
 
-    const Vid Sn_Age(Sn->age);
+    const Age Sn_Age(Sn->age);
+    const Age conflictAge(conflictCell->getAge());
     
-    conflictCell->addToBlockedList(Sn);
+    conflictCell->markWaiters();
+    waiters.park(conflictCell, conflictAge, Sn);
     
     //Conflict cell seems to be in progress, so mark this search as suspended
     Sn->suspendOn(conflictCell);
@@ -114,12 +122,21 @@ bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* con
 
     
     if(conflictCell->isComplete()){
-        if(Sn->suspendedOnCompareAndExchange(conflictCell, nullptr))
+        if(Sn->suspendedOnCompareAndExchange(conflictCell, nullptr)){
+            waiters.unpark(conflictCell, conflictAge, Sn); //The cell's waiters may already have been drained
+            blockingChanged(); //Other threads may have walked through Sn while it was suspended
             return RESUME;
+        }
         else
             return SUSPEND;
 
     }
+    
+    //Most suspensions do not close a cycle; find that out without building the path
+    Search* const S0(conflictCell->getOwner());
+    
+    if(!S0 || !reaches(worker, S0, Sn))
+        return SUSPEND;
 
     //We are reusing old empty vectors to represent the path of searches and cells
     //We reuse the memory to avoid allocating memory too much as memory is often
@@ -128,15 +145,15 @@ bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* con
     worker.cleanPaths(); //Refresh memory from previous usage
     std::vector<Search*>&    S = worker.S; //vector to record the path from S0 to Sn
     std::vector<Cell<Vid>*>& C = worker.C; //Ci is the cell of Si that the previous search blocks on
-    std::vector<Vid>&        L = worker.L; //Li = age of the search object Si
-    std::vector<Vid>&        A = worker.A; //Ai = age of the cell object Ci
+    std::vector<Age>&        L = worker.L; //Li = age of the search object Si
+    std::vector<Age>&        A = worker.A; //Ai = age of the cell object Ci
 
     
     /******* Check for cycle ********/
     
     //Path: first pass
     
-    Search* Si(Sn); Cell<Vid>* Ci; Vid Li, Ai;
+    Search* Si(Sn); Cell<Vid>* Ci; Age Li, Ai;
     
     //is there already a blocking path from S1 to Sn?
     
@@ -154,7 +171,7 @@ bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* con
         
         //We want to record the age of the cell Si was suspended on, hence we check
         //to make sure Si is still suspended on Ci after reading the age variable
-        Ai = Ci->age;
+        Ai = Ci->getAge();
         if(Si->getBlockingCell() != Ci) return SUSPEND;
     
         Si = Ci->getOwner();
@@ -197,7 +214,7 @@ bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* con
             return SUSPEND;
         
         //We checked completeness first! See note (*) above
-        if(Ci->age != A[i])
+        if(Ci->getAge() != A[i])
             return SUSPEND;
         
         if(Si < S[minPtr])
@@ -225,10 +242,12 @@ bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* con
      */
     
     Sn->removeCellBlockedOn();
-
+    blockingChanged();
     
     runCellTransfer(S, C); //Resolve the cycle
     
+    blockingChanged(); //Shortcuts recorded while the owners of the cells were changing are now stale
+    
 
     ++(S[minPtr]->age); //Make age of search even again to signal that the search is no longer in transfer
     
@@ -241,6 +260,68 @@ bool SuspensionManager::suspend(Worker& worker, Search* const Sn, Cell<Vid>* con
     
 }
 
+/*
+ Purpose: Returns true if the blocking path starting at the search from may lead to target, i.e. if target
+          suspending closes a cycle. Searches that are suspended on a cell of another search form a forest whose
+          roots are the searches that are running. Each search keeps a BlockingHint, a search further along its
+          path, and we follow the hints instead of the path wherever they are valid. When the walk ends at a root
+          R, every search it passed gets R as its hint, so the next walk through any of them jumps straight to R
+          (path compression, as in union-find).
+ 
+          A hint records that target was on the search's path. Suspending only adds edges at roots, which leaves
+          that true; every change that can remove an edge bumps blockingVersion, which invalidates all hints at
+          once. Like the first pass of suspend(), the walk reads the path one step at a time while other threads
+          change it, so a true return is only a candidate and suspend() verifies it. A false return is reliable in
+          the same sense as the first pass: if another thread closes a cycle through target at the same time, that
+          thread's walk sees it.
+ 
+          Returns false as well if a search on the path is in a transfer or a cell on it completed, in which case
+          suspend() would suspend anyway
+ */
+bool SuspensionManager::reaches(Worker& worker, Search* from, Search* const target){
+    
+    const uint64_t version(blockingVersion.load());
+    
+    std::vector<Search*>& visited = worker.S;
+    worker.cleanPaths();
+    
+    Search* Si(from); Cell<Vid>* Ci;
+    
+    while(true){
+        
+        if(Si == target) return true;
+        
+        if(Si->age & 1) return false; //Transfer in progress
+        
+        visited.push_back(Si);
+        
+        const BlockingHint hint(Si->hint.load());
+        
+        //Compared with the current version, not the one the walk started with: hints recorded by walks that
+        //raced with a change can point in a circle until the change bumps the version
+        if(hint.target && hint.version == blockingVersion.load()){
+            Si = hint.target; continue;
+        }
+        
+        Ci = Si->getBlockingCell();
+        if(!Ci) break; //Si is running, it is the root
+        
+        Si = Ci->getOwner();
+        if(!Si) return false; //Ci completed
+    }
+    
+    //Compress: every search we passed now points to the root. The hints carry the version the walk started
+    //with, so they are void if anything changed while we walked. The root itself may have been visited before,
+    //while it was still suspended; it must not point to itself
+    const BlockingHint toRoot{Si, version};
+    
+    for(Search* const passed: visited)
+        if(passed != Si)
+            passed->hint.store(toRoot);
+    
+    return false;
+}
+
 /**
  
  
@@ -292,7 +373,7 @@ void SuspensionManager::runCellTransfer(const std::vector<Search*>& S, const std
     
     //Traverse the path starting with the search that S is directly blocked on
     for(int i = 0; i < S.size() - 1; ++i)
-        Search::transferCells(S[i], Sn, C[i]);
+        Search::transferCells(S[i], Sn, C[i], waiters);
     
     //Makes sure S is "aware" that all transferred cells are in the same SCC,
     //make the new top of S's tarjan stack (last of the transferred cells) have rank
@@ -311,54 +392,33 @@ void SuspensionManager::runCellTransfer(const std::vector<Search*>& S, const std
           on the Pending object for resumption
 
  @param completeCell  The cell that has recently become complete
- @param blockedList The list of searches that may be blocked on completeCell
  @param toResume      A vector that will hold the searches that must be put on the Pending object for resumption
                  The Pending Queue is accessed by worker threads that
                  have finished their previous jobs and are looking for new searches to work on
 
- Purpose: The code looks a bit complicated because it is optimized for common conditions the algorithm faces 
-          Basically, after a cell is completed all the searches blocked on that cell must be resumed. Some of
-          the searches in the BlockedList; however, will no longer actually be suspended on the cell by the time this
-          function is called. The reason for this is that searches will sometimes unblock on a cell for
-          reasons other than it being complete (i.e. during a transfer) but it is more efficent to leave them in the
-          blockedList anyway as it allows a simpler of blockedList. To insure no searches that are not actually suspended
-          on blockedList are accidently resumed, we use a compare_and_exchange to verify that the search was actually
-          suspended on the cell
+ Purpose: The searches parked on the cell are taken out of the WaitTable. Some of them
+          will no longer actually be suspended on the cell by the time this function is called. The reason
+          for this is that searches will sometimes unblock on a cell for reasons other than it being complete
+          (i.e. during a transfer) but it is more efficent to leave them parked anyway. To insure no searches that
+          are not actually suspended on the cell are accidently resumed, we use a compare_and_exchange to verify
+          that the search was actually suspended on the cell
  
  */
-void SuspensionManager::bulkUnsuspend(BlockedList<Search*>* const blockedList, Cell<Vid>* const completeCell, std::vector<Search*>& toResume){
-    
-    Search* search; const int size(blockedList->size());
-    
-    //Cells will very rarely have more than a few searches suspended on them, so we optimize
-    //our algorithm to quickly deal with suspended. This allows us to save memory and time at the cost of
-    //slightly longer stores and retrievals when the suspended list is longer than 8.
-    //Because most graphs are large, it will be very rare when more than a few searches suspend on the same cell
-    //so the trade off is well worth it
-    
-    if(blockedList->isSmallList(size)){
-        std::atomic<Search*>* const suspendedSearches{blockedList->getSmallBuffer()};
-        for(int e = 0; e < size; ++e){
-            search = suspendedSearches[e].load(std::memory_order_relaxed);
-            if(search && search->removeCellBlockedOnWithCompareExchange(completeCell))
-                toResume.push_back(search);
-        }
-    }
+void SuspensionManager::bulkUnsuspend(Cell<Vid>* const completeCell, std::vector<Search*>& toResume){
     
-    else{
-        
-        auto suspendedListIt(blockedList->getIt(size));
-        
-        while(suspendedListIt.increment()){
-            search = suspendedListIt.getNext();
-            
-            if(search && search->removeCellBlockedOnWithCompareExchange(completeCell))
-                toResume.push_back(search);
-            
-        }
-        
-    }
+    waiters.unparkAll(completeCell, completeCell->getAge(), toResume);
+    
+    //Keep only the searches that were still suspended on the cell
+    size_t kept(0);
+    
+    for(Search* search: toResume)
+        if(search->removeCellBlockedOnWithCompareExchange(completeCell))
+            toResume[kept++] = search;
+    
+    toResume.resize(kept);
     
+    if(!toResume.empty())
+        blockingChanged();
     
 }
 
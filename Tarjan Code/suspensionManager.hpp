@@ -14,6 +14,7 @@
 #include "stealingQueue.hpp"
 #include <vector>
 #include "worker.hpp"
+#include "waitTable.hpp"
 
 #define SUSPEND true
 
@@ -33,14 +34,27 @@ private:
         search->removeCellBlockedOn();
     }
     
+    WaitTable waiters; //Searches suspended on cells
+    
     void runCellTransfer(const std::vector<Search*>& S, const std::vector<Cell<Vid>*>& C);
     
+    /*Bumped after every change that can remove an edge from the graph of blocked searches: a search
+     unsuspending, or a cell transfer changing the owners of cells. Suspensions only add edges, so a
+     BlockingHint recorded under the current version still holds*/
+    std::atomic<uint64_t> blockingVersion{1};
+    
+    inline void blockingChanged(){
+        blockingVersion.fetch_add(1);
+    }
+    
+    bool reaches(Worker& worker, Search* from, Search* const target);
+    
     
 public:
     
     bool suspend(Worker& worker, Search* const Sn, Cell<Vid>* const conflictCell);
     
-    void bulkUnsuspend(BlockedList<Search*>* const suspendedList, Cell<Vid>* const prevBlockedOn, std::vector<Search*>& toResume);
+    void bulkUnsuspend(Cell<Vid>* const completeCell, std::vector<Search*>& toResume);
     
 //    void bulkUnsuspendLF(BlockedList<Search*>* const suspendedList, Cell<Vid>* const prevBlockedOn, std::vector<Search*>& toResume){
 //        
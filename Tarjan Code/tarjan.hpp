@@ -11,45 +11,198 @@
 
 #include <stdio.h>
 #include <unordered_set>
+#include <thread>
+#include <chrono>
 #include "typedefs.h"
 #include "graph.h"
 #include "singleThreadedTarjan.h"
+#include "denseTarjan.hpp"
+#include "leanTarjan.hpp"
+#include "csrGraph.h"
+#include "vertexReordering.hpp"
+#include "compressedGraph.hpp"
 #include "multiThreadedTarjan.hpp"
 //#include "tbb_concurrent_map.h"
 #include "SimpleSharded.h"
 #include "ShardedSpinLock.h"
 #include "dictionaryFactory.h"
+#include "cancellationToken.h"
+#include "topology.hpp"
+#include "engineSelector.hpp"
 
 class Tarjan{
     
 public:
     
+    //Graphs with dense vertex ids (0 .. n-1) and no edges to missing vertices take the flat array implementation, see DenseTarjan
     static SCC_Set* singleThreadedTarjan(const Graph<Vid>& _graph){
+        if(DenseTarjan::applicable(_graph)){
+            DenseTarjan algorithm(_graph);
+            return algorithm.run();
+        }
+        
         SingleThreadedTarjan algorithm(_graph);
         return algorithm.run();
     }
     
+    /*Sequential run that needs about one word and one bit per vertex, for graphs too large for the hash map
+     based engine, see LeanTarjan. Graphs whose ids are not dense, or with edges to vertices the graph does
+     not have, fall back to singleThreadedTarjan*/
+    static SCC_Set* leanTarjan(const Graph<Vid>& _graph){
+        if(!DenseTarjan::applicable(_graph))
+            return singleThreadedTarjan(_graph);
+        
+        LeanTarjan algorithm(_graph);
+        return algorithm.run();
+    }
+    
+    //SCCs of the subgraph selected by filter, see SubgraphFilter. The graph is not copied
+    static SCC_Set* singleThreadedTarjan(const Graph<Vid>& _graph, const SubgraphFilter& filter){
+        SingleThreadedTarjan algorithm(_graph, &filter);
+        return algorithm.run();
+    }
+    
+    static SCC_Set* multiThreadedTarjan(const Graph<Vid>& _graph, const SubgraphFilter& filter, Vid num_threads = 4, DictType dType = OpenSharded){
+        
+        CancellationToken neverCancelled;
+        
+        return multiThreadedTarjan(_graph, neverCancelled, num_threads, dType, false, Affinity(), &filter).SCCs;
+    }
+    
     static SCC_Set* multiThreadedTarjan(const Graph<Vid>& _graph, Vid num_threads = 4, DictType dType =  OpenSharded
                     ){
         
-        Dictionary<Vid, WeakReference<Cell<Vid>>>* dict = DictionaryFactory::getDictionary<Vid, WeakReference<Cell<Vid>>>(dType);
+        CancellationToken neverCancelled;
         
-        LockFreePendingQueue pending;
-        
-        Vid numVerts; const Vid* vertices = _graph.getVerticesArray(numVerts);
+        return multiThreadedTarjan(_graph, neverCancelled, num_threads, dType).SCCs;
+    }
+    
+    /*Same as above, but the run stops early if token is cancelled or its time budget runs out.
+     In that case the result is marked incomplete and holds only the SCCs found so far.
+     With numaAware set, workers are pinned to NUMA nodes and start searches on their own node's share
+     of the vertices first. affinity pins each worker to a single CPU instead, see AffinityPolicy.
+     A filter restricts the run to a subgraph*/
+    static SCCResult multiThreadedTarjan(const Graph<Vid>& _graph, CancellationToken& token, Vid num_threads = 4, DictType dType =  OpenSharded, bool numaAware = false, const Affinity& affinity = Affinity(), const SubgraphFilter* filter = nullptr){
         
-        UnrootedStealingQueue freeCells(vertices, numVerts, *dict, num_threads);
+        Vid numVerts; roots(_graph, filter, numVerts);
         
-        MultiThreadedTarjan algorithm(_graph, *dict, num_threads, pending, freeCells);
+        //Sized for the vertices the run can visit, so small graphs do not pay for a full size dictionary
+        Dictionary<Vid, WeakReference<Cell<Vid>>>* dict = DictionaryFactory::getDictionary<Vid, WeakReference<Cell<Vid>>>(dType, numVerts);
         
-        SCC_Set* toReturn = algorithm.run();
+        SCCResult toReturn = runParallel(_graph, *dict, token, num_threads, numaAware, affinity, filter);
         
         delete dict;
         
         return toReturn;
     }
+    
+    /*Runs with a dictionary the caller keeps between runs, e.g. an OpenAddressedShardedMap, so that repeated
+     runs do not allocate and free one each time. The dictionary is reset before the run; if it does not
+     support reset() a fresh one of type fallback is used instead*/
+    static SCC_Set* multiThreadedTarjan(const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& dict, Vid num_threads = 4, DictType fallback = OpenSharded){
+        
+        CancellationToken neverCancelled;
+        
+        if(!dict.reset(_graph.size()))
+            return multiThreadedTarjan(_graph, neverCancelled, num_threads, fallback).SCCs;
+        
+        return runParallel(_graph, dict, neverCancelled, num_threads, false, Affinity(), nullptr).SCCs;
+    }
+    
+    /*Decomposes many graphs at once. Graphs with fewer than parallelThreshold vertices are small enough that
+     the parallel engine's setup costs more than it saves, so they are handed out one at a time to a pool of
+     num_threads threads, each running the single threaded algorithm on a whole graph. Larger graphs are then
+     run one after another with the multithreaded algorithm on all num_threads threads.
+     The result for graphs[i] is at index i of the returned vector; the caller owns every SCC_Set*/
+    static std::vector<SCC_Set*> batchTarjan(const std::vector<const Graph<Vid>*>& graphs, Vid num_threads = 4, Vid parallelThreshold = 1 << 16){
+        
+        std::vector<SCC_Set*> results(graphs.size(), nullptr);
+        std::vector<size_t> small, large;
+        
+        for(size_t g = 0; g < graphs.size(); ++g)
+            ((Vid) graphs[g]->size() < parallelThreshold ? small : large).push_back(g);
+        
+        //Small graphs: each pool thread takes the next graph off the list until none are left
+        std::atomic<size_t> next{0};
+        
+        auto poolThread = [&](){
+            for(size_t job = next++; job < small.size(); job = next++)
+                results[small[job]] = singleThreadedTarjan(*graphs[small[job]]);
+        };
+        
+        std::vector<std::thread> pool;
+        const size_t poolSize(std::min((size_t) std::max(num_threads, (Vid) 1), small.size()));
+        
+        for(size_t t = 1; t < poolSize; ++t)
+            pool.emplace_back(poolThread);
+        
+        poolThread(); //The calling thread works too
+        
+        for(std::thread& thread: pool) thread.join();
+        
+        for(size_t g: large)
+            results[g] = multiThreadedTarjan(*graphs[g], num_threads);
+        
+        return results;
+    }
+    
+    /*Picks the engine, thread count and dictionary from cheap statistics of the graph (see EngineSelector)
+     and runs it. If stats is given, the statistics, the decision with its reason, the run time and the number
+     of SCCs are written to it. maxThreads caps the number of threads; 0 means the hardware's*/
+    static SCC_Set* autoTarjan(const Graph<Vid>& _graph, RunStats* stats = nullptr, Vid maxThreads = 0){
+        
+        RunStats local; RunStats& run(stats ? *stats : local);
+        
+        if(!maxThreads) maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        
+        run.graph = EngineSelector::sample(_graph);
+        EngineSelector::choose(run, maxThreads);
+        
+        auto start = std::chrono::steady_clock::now();
+        
+        SCC_Set* SCCs = run.parallel ? multiThreadedTarjan(_graph, run.threads, run.dType) : singleThreadedTarjan(_graph);
+        
+        run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        run.numSCCs = SCCs->size();
+        
+        return SCCs;
+    }
 
     
+private:
+    
+    //The vertices searches start from: the filter's list if it has one, otherwise the whole graph
+    static const Vid* roots(const Graph<Vid>& _graph, const SubgraphFilter* filter, Vid& numVerts){
+        const Vid* vertices = filter ? filter->getVertices(numVerts) : nullptr;
+        
+        return vertices ? vertices : _graph.getVerticesArray(numVerts);
+    }
+    
+    static SCCResult runParallel(const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& dict, CancellationToken& token, Vid num_threads, bool numaAware, const Affinity& affinity, const SubgraphFilter* filter){
+        
+        WorkStealingPending pending(num_threads);
+        
+        Vid numVerts; const Vid* vertices = roots(_graph, filter, numVerts);
+        
+        StealingQueue* freeCells;
+        
+        if(numaAware)
+            freeCells = new NumaStealingQueue(vertices, numVerts, dict, Topology::get().numNodes());
+        else
+            freeCells = new UnrootedStealingQueue(vertices, numVerts, dict, num_threads);
+        
+        freeCells->restrictTo(filter);
+        
+        MultiThreadedTarjan algorithm(_graph, dict, num_threads, pending, *freeCells, token, numaAware, affinity, filter);
+        
+        SCCResult toReturn{algorithm.run(), false};
+        toReturn.complete = algorithm.isComplete();
+        
+        delete freeCells;
+        
+        return toReturn;
+    }
+    
 };
 
 
@@ -0,0 +1,183 @@
+//
+//  topology.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/14/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "topology.hpp"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+Topology::Topology(){
+
+#ifdef __linux__
+    for(int node = 0; ; ++node){
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if(!file) break;
+
+        std::string list;
+        std::getline(file, list);
+
+        std::vector<int> cpus(parseCPUList(list));
+        if(!cpus.empty()) //Memory only nodes have no CPUs to run workers on
+            nodeCPUs.push_back(cpus);
+    }
+#endif
+
+    if(nodeCPUs.empty()){
+        const int numCPUs(std::max(1u, std::thread::hardware_concurrency()));
+        nodeCPUs.emplace_back();
+
+        for(int cpu = 0; cpu < numCPUs; ++cpu)
+            nodeCPUs.back().push_back(cpu);
+    }
+    
+    for(unsigned int node = 0; node < nodeCPUs.size(); ++node)
+        for(int cpu: nodeCPUs[node]){
+            const std::string dir("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/");
+            cpus.push_back(CPU{cpu, (int) node, readInt(dir + "physical_package_id", 0), readInt(dir + "core_id", cpu)});
+        }
+    
+    std::sort(cpus.begin(), cpus.end(), [](const CPU& a, const CPU& b){
+        if(a.package != b.package) return a.package < b.package;
+        if(a.core != b.core)       return a.core < b.core;
+        return a.id < b.id;
+    });
+
+}
+
+int Topology::readInt(const std::string& path, int fallback){
+    std::ifstream file(path);
+    int value;
+    
+    if(file >> value)
+        return value;
+    
+    return fallback;
+}
+
+unsigned int Topology::nodeOfCPU(const int cpu) const{
+    for(const CPU& c: cpus)
+        if(c.id == cpu)
+            return c.node;
+    
+    return 0;
+}
+
+std::vector<int> Topology::placement(const Affinity& affinity, const unsigned int num_threads) const{
+    std::vector<int> order; //CPUs in the order the policy hands them out
+    
+    switch(affinity.policy){
+            
+        case NoAffinity:
+            return std::vector<int>(num_threads, -1);
+            
+        case CoreList:
+            order = affinity.cores;
+            break;
+            
+        case Compact:
+            for(const CPU& c: cpus)
+                order.push_back(c.id);
+            break;
+            
+        case NoSMT:
+            for(unsigned int i = 0; i < cpus.size(); ++i)
+                if(i == 0 || cpus[i].package != cpus[i-1].package || cpus[i].core != cpus[i-1].core)
+                    order.push_back(cpus[i].id);
+            break;
+            
+        case Scatter:{
+            /*Rank each CPU by how many of its siblings come before it (0 for the first hyperthread of a core)
+             and by the number of its core within its package. Handing out the CPUs by (rank, core number, package)
+             takes one core from every package in turn, and only uses second hyperthreads once every core is busy*/
+            struct Slot{ int sibling, coreNumber, package, id; };
+            std::vector<Slot> slots;
+            int sibling(0), coreNumber(-1);
+            
+            for(unsigned int i = 0; i < cpus.size(); ++i){
+                if(i == 0 || cpus[i].package != cpus[i-1].package){
+                    coreNumber = 0; sibling = 0;
+                }
+                else if(cpus[i].core != cpus[i-1].core){
+                    ++coreNumber; sibling = 0;
+                }
+                else ++sibling;
+                
+                slots.push_back(Slot{sibling, coreNumber, cpus[i].package, cpus[i].id});
+            }
+            
+            std::sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b){
+                if(a.sibling != b.sibling)       return a.sibling < b.sibling;
+                if(a.coreNumber != b.coreNumber) return a.coreNumber < b.coreNumber;
+                return a.package < b.package;
+            });
+            
+            for(const Slot& slot: slots)
+                order.push_back(slot.id);
+            
+            break;
+        }
+    }
+    
+    if(order.empty())
+        return std::vector<int>(num_threads, -1);
+    
+    std::vector<int> placed(num_threads);
+    
+    for(unsigned int worker = 0; worker < num_threads; ++worker)
+        placed[worker] = order[worker % order.size()];
+    
+    return placed;
+}
+
+const Topology& Topology::get(){
+    static const Topology topology;
+    return topology;
+}
+
+std::vector<int> Topology::parseCPUList(const std::string& list){
+    std::vector<int> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+
+    while(std::getline(ranges, range, ',')){
+        if(range.empty()) continue;
+
+        const size_t dash(range.find('-'));
+        const int first(std::stoi(range.substr(0, dash)));
+        const int last(dash == std::string::npos ? first : std::stoi(range.substr(dash + 1)));
+
+        for(int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+bool Topology::pinCurrentThread(const std::vector<int>& cpus){
+
+#ifdef __linux__
+    if(cpus.empty()) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for(int cpu: cpus)
+        CPU_SET(cpu, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+
+}
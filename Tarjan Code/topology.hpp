@@ -0,0 +1,94 @@
+//
+//  topology.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/14/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef topology_hpp
+#define topology_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+/** Where the worker threads may run.
+ 
+ NoAffinity     The OS places and migrates the threads as it likes
+ Compact        Workers fill the machine in order: both hyperthreads of a core, then the next core, then the next socket
+ Scatter        Consecutive workers go to different sockets, then different cores, before sharing a core
+ NoSMT          Like Compact but only one logical CPU per physical core, skipping hyperthread siblings
+ CoreList       Worker i runs on cores[i], wrapping around if there are more workers than cores
+ 
+ Under every policy but NoAffinity each worker is pinned to a single logical CPU. If there are more workers
+ than CPUs the policy wraps around.
+ */
+
+enum AffinityPolicy{NoAffinity, Compact, Scatter, NoSMT, CoreList};
+
+struct Affinity{
+    AffinityPolicy   policy;
+    std::vector<int> cores; //Only used by CoreList
+    
+    Affinity(AffinityPolicy _policy = NoAffinity) : policy(_policy){;}
+    Affinity(const std::vector<int>& _cores) : policy(CoreList), cores(_cores){;}
+};
+
+/** The machine's NUMA nodes, sockets, cores and logical CPUs. On Linux it is read from sysfs
+ (/sys/devices/system/node and /sys/devices/system/cpu). Where that is not available, e.g. on macOS,
+ the machine is treated as a single node and socket where every CPU is its own core, and pinning is a no-op.
+ */
+
+class Topology{
+
+private:
+
+    struct CPU{
+        int id;
+        int node;
+        int package; //Socket
+        int core;    //Physical core within the package. Hyperthread siblings share it
+    };
+
+    std::vector<std::vector<int>> nodeCPUs; //Logical CPUs of each node, in ascending order
+    std::vector<CPU> cpus; //Sorted by package, core and id, i.e. in Compact order
+
+    Topology();
+    
+    static int readInt(const std::string& path, int fallback);
+
+public:
+
+    //Read once, the first time it is needed
+    static const Topology& get();
+
+    inline unsigned int numNodes() const{
+        return (unsigned int) nodeCPUs.size();
+    }
+
+    inline const std::vector<int>& cpusOf(const unsigned int node) const{
+        return nodeCPUs[node];
+    }
+
+    //Node that the index'th of num_threads workers runs on when workers are spread over the nodes in blocks
+    inline unsigned int nodeOfWorker(const unsigned int index, const unsigned int num_threads) const{
+        return (unsigned int) ((unsigned long) index * numNodes() / num_threads);
+    }
+
+    //Node that a logical CPU belongs to, 0 if the CPU is unknown
+    unsigned int nodeOfCPU(const int cpu) const;
+    
+    //The logical CPU each of num_threads workers should be pinned to, or -1 for every worker under NoAffinity
+    std::vector<int> placement(const Affinity& affinity, const unsigned int num_threads) const;
+
+    //Parses a sysfs cpu list such as "0-3,8-11"
+    static std::vector<int> parseCPUList(const std::string& list);
+
+    //Restricts the calling thread to the given CPUs. Returns false if the platform does not support it
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+};
+
+
+#endif /* topology_hpp */
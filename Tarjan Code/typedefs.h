@@ -22,11 +22,34 @@ class Search; class Worker;
 template <class V>
 class Cell;
 
+/*Integer types used by the algorithms. Vid identifies a vertex, Idx is the type of the index and rank
+ counters a search hands out to its cells and Age counts how many times a Cell or Search object has been
+ recycled. By default vertex identifiers are 32 bits. Compiling with TARJAN_64BIT_IDS defined switches
+ Vid (and with it Idx, since a search can hold every vertex) to 64 bits for state spaces with more
+ than 2^32 states. Age widens along with them: a cell's age keeps a flag in its low bit (see Cell), and with
+ that many states a worker reusing the same freed cell could wrap the remaining 31 bits, letting a stale
+ WeakReference in the dictionary match the cell's current lifetime*/
+
+#ifdef TARJAN_64BIT_IDS
+typedef uint64_t     Vid; //Identifier for vertexes in graph
+typedef uint64_t     Age;
+#else
 typedef unsigned int Vid; //Identifier for vertexes in graph
+typedef unsigned int Age;
+#endif
+
+typedef Vid          Idx;
 
 typedef std::vector<Vid> SCC;
 typedef std::vector<SCC*> SCC_Set;
 
+//Returned by runs that can be cancelled. If complete is false, the run was aborted and SCCs
+//only holds the components found before the abort; every SCC in it is still a whole SCC
+struct SCCResult{
+    SCC_Set* SCCs;
+    bool     complete;
+};
+
 class Search;
 
 
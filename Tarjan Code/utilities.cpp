@@ -199,7 +199,7 @@ void Utility::shuffleArray(Vid* array, Vid size){
 }
 
 // vertex = cluster + numClusters*x
-Graph<Vid>* Utility::clusters(const int numClusters, const int clusterSize, const int numNeighbors, const int interClusterConnections){
+Graph<Vid>* Utility::clusters(const int numClusters, const int clusterSize, const int numNeighbors, const int interClusterConnections, bool compact){
     
 
     Graph<Vid>* graph = new AdjacencyListGraph<Vid>;
@@ -250,7 +250,7 @@ Graph<Vid>* Utility::clusters(const int numClusters, const int clusterSize, cons
 
     }
     graph->updateVertexArray();
-    return graph;
+    return compact ? compactIds(graph) : graph;
     
 }
 
@@ -269,7 +269,7 @@ Graph<Vid>* Utility::clusters(const int numClusters, const int clusterSize, cons
  
  
  */
-Graph<Vid>* Utility::importGraphFromCSP(std::string filename){
+Graph<Vid>* Utility::importGraphFromCSP(std::string filename, bool compact){
     
     std::ifstream file(filename);
     std::string line;
@@ -303,7 +303,24 @@ Graph<Vid>* Utility::importGraphFromCSP(std::string filename){
 
     }
     
-    return new AdjacencyListGraph<Vid>(std::move(*graph));
+    Graph<Vid>* const imported = new AdjacencyListGraph<Vid>(std::move(*graph));
+    
+    return compact ? compactIds(imported) : imported;
+}
+
+ReorderedGraph* Utility::compactIds(Graph<Vid>* graph, Vid num_threads){
+    
+    ReorderedGraph* compacted;
+
+    try{
+        compacted = VertexReordering::compact(*graph, num_threads);
+    }catch(...){
+        delete graph; //We own it either way
+        throw;
+    }
+    
+    delete graph;
+    return compacted;
 }
 
 
@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include "directedHashGraph.h"
+#include "vertexReordering.hpp"
 #include "typedefs.h"
 #include <random>       // for pseudo-random number generators and distributions
 
@@ -21,6 +22,8 @@ class Utility{
 public:
     
     static bool initialized;
+    
+    //These generators try every vertex pair on one engine; see Generators for parallel O(n + m) versions
     static Graph<Vid>* generateRandomGraph(double edgeProb, const Vid& size);
     static Graph<Vid>* GeoGenerateRandomGraph(double edgeProb, const double& corr, const Vid& size);
     
@@ -35,11 +38,16 @@ public:
     
     static int randomInt(int lo, int hi);
     
-    static Graph<Vid>* clusters(const int numClusters, const int clusterSize, const int numNeighbors, const int interClusterConnections);
+    static Graph<Vid>* clusters(const int numClusters, const int clusterSize, const int numNeighbors, const int interClusterConnections, bool compact = false);
     
     static void shuffleArray(Vid* array, Vid size);
     
-    static Graph<Vid>* importGraphFromCSP(std::string filename);
+    static Graph<Vid>* importGraphFromCSP(std::string filename, bool compact = false);
+    
+    /*Replaces graph, which is deleted, by a copy with ids 0 .. n-1, see VertexReordering::compact.
+     The loaders above do this when compact is set; their result is then a ReorderedGraph, whose
+     restoreIds() translates SCCs back to the ids of the file or generator*/
+    static ReorderedGraph* compactIds(Graph<Vid>* graph, Vid num_threads = 8);
     
     
     
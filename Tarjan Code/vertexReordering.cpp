@@ -0,0 +1,250 @@
+//
+//  vertexReordering.cpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/29/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#include "vertexReordering.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include "parallelFor.h"
+
+const char* reorderPolicyName(const ReorderPolicy policy){
+    switch(policy){
+        case BFSOrder:    return "BFS order";
+        case RCMOrder:    return "RCM order";
+        case DegreeOrder: return "degree order";
+        default:          return "original order";
+    }
+}
+
+VertexReordering::Positions::Positions(const Vid* const vertices, const Vid n, const Vid num_threads) : dense(true){
+
+    //Same test as DenseTarjan::applicable: ids below n without duplicates are exactly 0 .. n-1
+    for(Vid v = 0; v < n && dense; ++v)
+        dense = vertices[v] < n;
+
+    if(dense){
+        //Dense ids can still be listed in any order, so we keep the positions in a flat array
+        denseIds.resize(n);
+
+        parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+            for(Vid v = begin; v < end; ++v) denseIds[vertices[v]] = v;
+        });
+        return;
+    }
+
+    /*Positions are first bucketed by shard with a parallel counting sort over slices of the vertex array, then
+     each thread fills whole shards from their buckets, so the maps need no locking and every id is read
+     a fixed number of times however many shards there are*/
+    const Vid slices(std::max((Vid) 1, std::min(num_threads, n)));
+    std::vector<size_t> start((size_t) slices * SHARDS, 0); //start[slice * SHARDS + shard], counts at first
+    std::vector<uint8_t> shardIds(n);
+
+    parallelFor(slices, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid slice = begin; slice < end; ++slice){
+            size_t* const count(start.data() + (size_t) slice * SHARDS);
+
+            for(Vid v = Vid((uint64_t) n * slice / slices); v < Vid((uint64_t) n * (slice + 1) / slices); ++v)
+                ++count[shardIds[v] = (uint8_t) shardOf(vertices[v])];
+        }
+    });
+
+    //Shard by shard, and within a shard slice by slice, so each shard's bucket is contiguous
+    std::vector<size_t> bucketEnd(SHARDS);
+    size_t total(0);
+
+    for(Vid shard = 0; shard < SHARDS; ++shard){
+        for(Vid slice = 0; slice < slices; ++slice){
+            const size_t count(start[(size_t) slice * SHARDS + shard]);
+            start[(size_t) slice * SHARDS + shard] = total;
+            total += count;
+        }
+        bucketEnd[shard] = total;
+    }
+
+    std::vector<Vid> buckets(n);
+
+    parallelFor(slices, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid slice = begin; slice < end; ++slice){
+            size_t* const next(start.data() + (size_t) slice * SHARDS);
+
+            for(Vid v = Vid((uint64_t) n * slice / slices); v < Vid((uint64_t) n * (slice + 1) / slices); ++v)
+                buckets[next[shardIds[v]]++] = v;
+        }
+    });
+
+    sparse.resize(SHARDS);
+
+    parallelFor(SHARDS, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid shard = begin; shard < end; ++shard){
+            const size_t first(shard ? bucketEnd[shard - 1] : 0);
+
+            sparse[shard].reserve(bucketEnd[shard] - first);
+
+            for(size_t b = first; b < bucketEnd[shard]; ++b)
+                sparse[shard][vertices[buckets[b]]] = buckets[b];
+        }
+    });
+}
+
+ReorderedGraph* VertexReordering::reorder(const Graph<Vid>& graph, const ReorderPolicy policy, const Vid num_threads){
+
+    Vid n;
+    const Vid* const vertices(graph.getVerticesArray(n));
+
+    const Positions position(vertices, n, num_threads);
+
+    if(!closed(graph, vertices, n, position, num_threads))
+        throw std::invalid_argument("VertexReordering: an edge leads to a vertex that is not in the graph");
+
+    const std::vector<Vid> degree(degrees(graph, vertices, n, num_threads));
+
+    //order[new id] is the position in vertices of the vertex that gets that id
+    std::vector<Vid> order;
+
+    switch(policy){
+        case BFSOrder:    order = breadthFirst(graph, vertices, position, degree, false); break;
+        case RCMOrder:    order = breadthFirst(graph, vertices, position, degree, true);  break;
+        case DegreeOrder: order = byDegree(degree, true); break;
+        default:
+            order.resize(n);
+            for(Vid v = 0; v < n; ++v) order[v] = v;
+    }
+
+    std::vector<Vid> newId(n), newToOld(n);
+    std::vector<size_t> offsets(n + 1, 0);
+
+    parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid id = begin; id < end; ++id){
+            newId[order[id]]  = id;
+            newToOld[id]      = vertices[order[id]];
+            offsets[id + 1]   = degree[order[id]];
+        }
+    });
+
+    for(Vid id = 0; id < n; ++id)
+        offsets[id + 1] += offsets[id];
+
+    std::vector<Vid> targets(offsets[n]);
+
+    parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+        Vid deg;
+
+        for(Vid id = begin; id < end; ++id){
+            const Vid* const succs(graph.getNeighborSpan(newToOld[id], deg));
+            Vid* const out(targets.data() + offsets[id]);
+
+            for(Vid e = 0; e < deg; ++e)
+                out[e] = newId[position[succs[e]]];
+        }
+    });
+
+    return new ReorderedGraph(n, std::move(offsets), std::move(targets), std::move(newToOld));
+}
+
+bool VertexReordering::closed(const Graph<Vid>& graph, const Vid* const vertices, const Vid n,
+                              const Positions& position, const Vid num_threads){
+    std::atomic<bool> missing(false);
+
+    parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+        Vid deg;
+
+        for(Vid v = begin; v < end && !missing.load(std::memory_order_relaxed); ++v){
+            const Vid* const succs(graph.getNeighborSpan(vertices[v], deg));
+
+            for(Vid e = 0; e < deg; ++e)
+                if(!position.contains(succs[e])){
+                    missing.store(true, std::memory_order_relaxed);
+                    break;
+                }
+        }
+    });
+
+    return !missing.load();
+}
+
+std::vector<Vid> VertexReordering::degrees(const Graph<Vid>& graph, const Vid* const vertices, const Vid n, const Vid num_threads){
+    std::vector<Vid> degree(n);
+
+    parallelFor(n, num_threads, [&](const Vid begin, const Vid end){
+        for(Vid v = begin; v < end; ++v)
+            graph.getNeighborSpan(vertices[v], degree[v]);
+    });
+
+    return degree;
+}
+
+std::vector<Vid> VertexReordering::byDegree(const std::vector<Vid>& degree, const bool descending){
+    const Vid n((Vid) degree.size());
+    const Vid maxDegree(n ? *std::max_element(degree.begin(), degree.end()) : 0);
+
+    std::vector<Vid> start(maxDegree + 2, 0), sorted(n);
+
+    for(Vid v = 0; v < n; ++v)
+        ++start[(descending ? maxDegree - degree[v] : degree[v]) + 1];
+
+    for(Vid d = 0; d <= maxDegree; ++d)
+        start[d + 1] += start[d];
+
+    for(Vid v = 0; v < n; ++v)
+        sorted[start[descending ? maxDegree - degree[v] : degree[v]]++] = v;
+
+    return sorted;
+}
+
+std::vector<Vid> VertexReordering::breadthFirst(const Graph<Vid>& graph, const Vid* const vertices, const Positions& position,
+                                                const std::vector<Vid>& degree, const bool cuthillMcKee){
+    const Vid n((Vid) degree.size());
+
+    //Cuthill-McKee starts each tree at a lowest degree vertex, plain BFS at the first unvisited one
+    std::vector<Vid> starts;
+    if(cuthillMcKee) starts = byDegree(degree, false);
+
+    std::vector<bool> visited(n, false);
+    std::vector<Vid> order; order.reserve(n);
+
+    auto lowerDegree = [&](const Vid a, const Vid b){return degree[a] < degree[b];};
+
+    for(Vid s = 0; s < n; ++s){
+        const Vid start(cuthillMcKee ? starts[s] : s);
+        if(visited[start]) continue;
+
+        visited[start] = true;
+        order.push_back(start);
+
+        //order doubles as the BFS queue: the vertices from head on are discovered but not yet expanded
+        for(size_t head = order.size() - 1; head < order.size(); ++head){
+            const size_t firstChild(order.size());
+            Vid deg;
+            const Vid* const succs(graph.getNeighborSpan(vertices[order[head]], deg));
+
+            for(Vid e = 0; e < deg; ++e){
+                const Vid child(position[succs[e]]);
+
+                if(!visited[child]){
+                    visited[child] = true;
+                    order.push_back(child);
+                }
+            }
+
+            if(cuthillMcKee)
+                std::stable_sort(order.begin() + firstChild, order.end(), lowerDegree);
+        }
+    }
+
+    if(cuthillMcKee) std::reverse(order.begin(), order.end());
+
+    return order;
+}
+
+void ReorderedGraph::restoreIds(SCC_Set& SCCs, const Vid num_threads) const{
+    parallelFor((Vid) SCCs.size(), num_threads, [&](const Vid begin, const Vid end){
+        for(Vid s = begin; s < end; ++s)
+            for(Vid& vertex: *SCCs[s])
+                vertex = newToOld[vertex];
+    });
+}
@@ -0,0 +1,114 @@
+//
+//  vertexReordering.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/29/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef vertexReordering_hpp
+#define vertexReordering_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <unordered_map>
+#include "typedefs.h"
+#include "graph.h"
+#include "csrGraph.h"
+
+/*How VertexReordering relabels the vertices.
+ BFSOrder numbers vertices in breadth first order from each unvisited vertex in turn, so a vertex's
+ successors mostly get nearby numbers. RCMOrder is reverse Cuthill-McKee: breadth first from a lowest degree
+ vertex, successors taken in increasing degree, and the whole order reversed. DegreeOrder puts high out degree
+ vertices first so the hubs' cells and edges share cache lines*/
+enum ReorderPolicy{NoReorder, BFSOrder, RCMOrder, DegreeOrder};
+
+const char* reorderPolicyName(ReorderPolicy policy);
+
+/*A graph relabelled or compacted by VertexReordering. It is a CSRGraph over the new ids 0 .. n-1, so every engine runs on it
+ unchanged, and it keeps the original id of each new id to translate results back with restoreIds()*/
+class ReorderedGraph: public CSRGraph<Vid>{
+
+    friend class VertexReordering;
+
+    std::vector<Vid> newToOld;
+
+    ReorderedGraph(const Vid n, std::vector<size_t>&& offsets, std::vector<Vid>&& targets, std::vector<Vid>&& _newToOld)
+    : CSRGraph<Vid>(n, std::move(offsets), std::move(targets)), newToOld(std::move(_newToOld)){;}
+
+public:
+
+    inline Vid originalId(const Vid vertex) const {return newToOld[vertex];}
+
+    //originalIds()[v] is the source graph's id of vertex v
+    inline const std::vector<Vid>& originalIds() const {return newToOld;}
+
+    //Rewrites the members of SCCs, found on this graph, to the ids of the graph it was built from
+    void restoreIds(SCC_Set& SCCs, Vid num_threads = 4) const;
+
+};
+
+/*Relabels a graph's vertices for locality before a run. Our CSP graphs number states with no relation to
+ their edges, so the DFS in Worker::execute jumps across the adjacency and the dictionary at every step.
+ After relabelling, vertices visited close together in time mostly have close ids, and the CSR layout puts
+ their edges next to each other as well.
+
+ Graph ids may be sparse; they are compacted to 0 .. n-1 on the way. The out degrees and the permuted CSR are
+ computed on num_threads threads. The BFS and RCM orders themselves come from one sequential traversal,
+ which is a single pass over the edges and small next to the copy*/
+
+class VertexReordering{
+
+    /*Maps a vertex of the source graph to its position in the source's vertex array. Sparse ids go in
+     SHARDS hash maps by a hash of the id, and each map is filled by one thread*/
+    class Positions{
+        const static Vid SHARDS = 64;
+
+        bool dense;
+        std::vector<Vid> denseIds;
+        std::vector<std::unordered_map<Vid, Vid>> sparse;
+
+        static inline Vid shardOf(const Vid vertex){
+            return (Vid) (((uint64_t) vertex * 0x9E3779B97F4A7C15ULL) >> 58); //Top 6 bits, SHARDS = 64
+        }
+
+    public:
+        Positions(const Vid* vertices, Vid n, Vid num_threads);
+
+        inline Vid operator[](const Vid vertex) const{
+            return dense ? denseIds[vertex] : sparse[shardOf(vertex)].at(vertex);
+        }
+
+        inline bool contains(const Vid vertex) const{
+            return dense ? vertex < denseIds.size() : sparse[shardOf(vertex)].count(vertex) != 0;
+        }
+    };
+
+    /*Whether every successor is a vertex of the graph. The copy and the BFS look successors up in position,
+     which would read past denseIds, or throw inside a worker thread, for an edge to a missing vertex*/
+    static bool closed(const Graph<Vid>& graph, const Vid* vertices, Vid n, const Positions& position, Vid num_threads);
+
+    static std::vector<Vid> degrees(const Graph<Vid>& graph, const Vid* vertices, Vid n, Vid num_threads);
+
+    //Positions sorted by degree, a stable counting sort
+    static std::vector<Vid> byDegree(const std::vector<Vid>& degree, bool descending);
+
+    static std::vector<Vid> breadthFirst(const Graph<Vid>& graph, const Vid* vertices, const Positions& position,
+                                         const std::vector<Vid>& degree, bool cuthillMcKee);
+
+public:
+
+    /*The relabelled copy of graph, which the caller owns. NoReorder keeps the vertex array's order. Throws
+     std::invalid_argument if an edge leads to a vertex the graph does not have, e.g. one added by
+     AdjacencyListGraph::insertEdge, which does not create its target*/
+    static ReorderedGraph* reorder(const Graph<Vid>& graph, ReorderPolicy policy, Vid num_threads = 4);
+
+    /*Only compacts the ids to 0 .. n-1, in the order of the vertex array. Engines then take their array
+     indexed paths, e.g. DenseTarjan, and restoreIds() gives back the source's ids*/
+    static ReorderedGraph* compact(const Graph<Vid>& graph, Vid num_threads = 4){
+        return reorder(graph, NoReorder, num_threads);
+    }
+
+};
+
+#endif /* vertexReordering_hpp */
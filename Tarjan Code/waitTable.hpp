@@ -0,0 +1,118 @@
+//
+//  waitTable.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/28/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef waitTable_hpp
+#define waitTable_hpp
+
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+#include "typedefs.h"
+
+/** Parking lot for searches suspended on cells.
+
+ Almost no cell ever has a search waiting on it, so instead of every cell carrying a list of waiters, the
+ waiters of all cells live in one hashed table keyed by the cell's address and age. A cell only keeps a
+ "has waiters" bit (see Cell::markWaiters()), and completing a cell without that bit costs nothing extra.
+ Completing a cell with waiters drains the one bucket the key hashes to.
+
+ Keying by age as well as address keeps waiters of an earlier lifetime of a recycled cell object apart from
+ the current one. Buckets are small vectors behind a spin lock; contention is low because a bucket is only
+ touched by searches suspending on, or completing, cells that hash to it.
+
+ Entries may go stale: a search resumed by a cell transfer stays parked until the cell completes, when the
+ drain finds it no longer suspended on the cell and drops it (see SuspensionManager::bulkUnsuspend()).
+ */
+
+class WaitTable{
+
+    const static int BITS = 10;
+    const static int BUCKETS = 1 << BITS;
+
+    struct Waiter{
+        const void* cell;
+        Age         age;
+        Search*     search;
+    };
+
+    struct alignas(64) Bucket{
+        std::atomic_bool    locked{false};
+        std::vector<Waiter> waiters;
+    };
+
+    Bucket buckets[BUCKETS];
+
+    static inline size_t bucketOf(const void* const cell, const Age age){
+        uint64_t x((uint64_t) (uintptr_t) cell ^ ((uint64_t) age << 32));
+        x = ((x >> 30) ^ x) * 0xbf58476d1ce4e5b9ULL;
+        x = ((x >> 27) ^ x) * 0x94d049bb133111ebULL;
+        return (size_t) ((x >> 31) ^ x) & (BUCKETS - 1);
+    }
+
+    static inline void lock(Bucket& bucket){
+        while(true){
+            while(bucket.locked.load(std::memory_order_relaxed)){};
+            bool f(false);
+            if(bucket.locked.compare_exchange_weak(f, true, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    static inline void unlock(Bucket& bucket){
+        bucket.locked.store(false, std::memory_order_release);
+    }
+
+public:
+
+    //Registers search as waiting on the cell in its lifetime age
+    void park(const void* const cell, const Age age, Search* const search){
+        Bucket& bucket(buckets[bucketOf(cell, age)]);
+
+        lock(bucket);
+        bucket.waiters.push_back(Waiter{cell, age, search});
+        unlock(bucket);
+    }
+
+    //Removes one registration of search on the cell, if there is one
+    void unpark(const void* const cell, const Age age, Search* const search){
+        Bucket& bucket(buckets[bucketOf(cell, age)]);
+
+        lock(bucket);
+
+        std::vector<Waiter>& waiters(bucket.waiters);
+
+        for(size_t w = 0; w < waiters.size(); ++w)
+            if(waiters[w].cell == cell && waiters[w].age == age && waiters[w].search == search){
+                waiters[w] = waiters.back(); waiters.pop_back(); //Order does not matter
+                break;
+            }
+
+        unlock(bucket);
+    }
+
+    //Removes every search waiting on the cell in its lifetime age and appends them to parked
+    void unparkAll(const void* const cell, const Age age, std::vector<Search*>& parked){
+        Bucket& bucket(buckets[bucketOf(cell, age)]);
+
+        lock(bucket);
+
+        std::vector<Waiter>& waiters(bucket.waiters);
+
+        for(size_t w = 0; w < waiters.size();)
+            if(waiters[w].cell == cell && waiters[w].age == age){
+                parked.push_back(waiters[w].search);
+                waiters[w] = waiters.back(); waiters.pop_back();
+            }
+            else ++w;
+
+        unlock(bucket);
+    }
+
+};
+
+#endif /* waitTable_hpp */
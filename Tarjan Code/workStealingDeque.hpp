@@ -0,0 +1,154 @@
+//
+//  workStealingDeque.hpp
+//  Tarjan
+//
+//  Created by Alex Zabrodskiy on 9/12/17.
+//  Copyright © 2017 Alex Zabrodskiy. All rights reserved.
+//
+
+#ifndef workStealingDeque_hpp
+#define workStealingDeque_hpp
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+/** Chase-Lev work stealing deque (with the memory orderings of Le, Pop, Cohen and Zappa Nardelli,
+ "Correct and Efficient Work-Stealing for Weak Memory Models").
+
+ Only the owning thread may call push() and pop(), which work on the bottom of the deque, so the
+ owner gets back the element it pushed most recently. Any thread may call steal(), which takes the
+ oldest element from the top. The owner only synchronizes with thieves when the deque is
+ down to its last element.
+
+ T must be a pointer type. A null value means the deque was empty, or that a steal lost a race.
+ The ring buffer grows when it fills up. The old buffers are kept until the deque is destroyed,
+ because a thief may still be reading from them.
+ */
+
+template <class T>
+class WorkStealingDeque{
+
+private:
+
+    struct RingBuffer{
+        const int64_t capacity;
+        const int64_t mask;
+        std::atomic<T>* const slots;
+
+        RingBuffer(const int64_t _capacity) : capacity(_capacity), mask(_capacity - 1), slots(new std::atomic<T>[_capacity]){;}
+
+        ~RingBuffer(){
+            delete[] slots;
+        }
+
+        inline T get(const int64_t i){
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+
+        inline void put(const int64_t i, T const item){
+            slots[i & mask].store(item, std::memory_order_relaxed);
+        }
+
+        //Copies the elements in [top, bottom) into a buffer twice as large
+        RingBuffer* grow(const int64_t bottom, const int64_t top){
+            RingBuffer* bigger(new RingBuffer(capacity << 1));
+
+            for(int64_t i = top; i < bottom; ++i)
+                bigger->put(i, get(i));
+
+            return bigger;
+        }
+    };
+
+    const static int64_t INITIAL_CAPACITY = 32; //Must be a power of 2
+
+    //Thieves hammer top and the owner hammers bottom, so they get separate cache lines
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<RingBuffer*> buffer;
+    std::vector<RingBuffer*> oldBuffers; //Only touched by the owner
+
+public:
+
+    WorkStealingDeque() : top(0), bottom(0), buffer(new RingBuffer(INITIAL_CAPACITY)){;}
+
+    ~WorkStealingDeque(){
+        delete buffer.load();
+
+        for(RingBuffer* old: oldBuffers)
+            delete old;
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator = (const WorkStealingDeque&) = delete;
+
+    //Owner only
+    void push(T const item){
+        const int64_t b(bottom.load(std::memory_order_relaxed));
+        const int64_t t(top.load(std::memory_order_acquire));
+        RingBuffer* ring(buffer.load(std::memory_order_relaxed));
+
+        if(b - t > ring->capacity - 1){
+            oldBuffers.push_back(ring);
+            ring = ring->grow(b, t);
+            buffer.store(ring, std::memory_order_release);
+        }
+
+        ring->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    //Owner only. Returns the most recently pushed element, or null if the deque is empty
+    T pop(){
+        const int64_t b(bottom.load(std::memory_order_relaxed) - 1);
+        RingBuffer* const ring(buffer.load(std::memory_order_relaxed));
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t(top.load(std::memory_order_relaxed));
+
+        if(t > b){ //Empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T item(ring->get(b));
+
+        if(t == b){ //Last element, race the thieves for it
+            if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    //Any thread. Returns the oldest element, or null if the deque is empty or another thread got there first
+    T steal(){
+        int64_t t(top.load(std::memory_order_acquire));
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b(bottom.load(std::memory_order_acquire));
+
+        if(t >= b)
+            return nullptr;
+
+        RingBuffer* const ring(buffer.load(std::memory_order_acquire));
+        T item(ring->get(t));
+
+        if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return item;
+    }
+
+    //Only a hint when other threads are using the deque
+    inline bool empty() const{
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+};
+
+
+#endif /* workStealingDeque_hpp */
@@ -8,27 +8,31 @@
 
 #include "worker.hpp"
 #include "multiThreadedTarjan.hpp"
-#include  "Reference.hpp"
-#include "ShardedSpinLock.h"
+#include "topology.hpp"
 
 
-Worker::Worker(unsigned int _ID, MultiThreadedTarjan& _algo, const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict) : ID(_ID), MASK(1LL<<_ID), scheduler(_algo), graph(_graph), dict(_dict), spareSearch(new Search) {
+Worker::Worker(unsigned int _ID, MultiThreadedTarjan& _algo, const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict, EpochManager& _epochs, const SubgraphFilter* _filter) : ID(_ID), MASK(1LL<<_ID), scheduler(_algo), graph(_graph), dict(_dict), filter(_filter), epochs(_epochs), node(0), pollCountdown(POLL_INTERVAL), transientSpans(_graph.transientSpans()) {
     
-    allocateSpareCell();
     recycledCells.reserve(10);
 }
 
 void Worker::operator()(){
     
-    Cell<Vid>::RECYCLED_CELLS = &recycledCells;
+    //Pin the thread before it allocates anything, so that its cells and searches
+    //are first touched on the node it runs on
+    if(!cpus.empty())
+        Topology::pinCurrentThread(cpus);
+    
+    allocateSpareSearch();
+    allocateSpareCell();
     
     Search* search;
     
     while(true){
         
         search = scheduler.getSearch(this);
-        if(!search){
-            cleanUp();
+        if(!search){ //Memory is released by the scheduler once all threads are done
+            epochs.exit(ID);
             return;
         }
         
@@ -40,27 +44,35 @@ void Worker::operator()(){
 
 void Worker::execute(Search* const search){
     Cell<Vid>* curr, *child;
+    WeakReference<Cell<Vid>> succ;
     char attempt;
     
     while(!search->controlStackEmpty()){
         
+        //If the run was cancelled, abandon the search. It is freed along with everything
+        //else the workers allocated when the run finishes.
+        //The top of the loop is also a quiescent point: the only cells we hold on to between iterations
+        //are on our own stacks or are only ever used after an age check. Announcing it every iteration
+        //would cost a fence per edge, so we only do it every POLL_INTERVAL iterations
+        if(--pollCountdown == 0){
+            pollCountdown = POLL_INTERVAL;
+            if(scheduler.cancelled())
+                return;
+            
+            epochs.enter(ID);
+        }
+        
         curr = search->controlStackTop();
 
-        if(!curr->allNeighborsDone()){
+        if(getBestNeighbor(curr, succ)){
             
-            WeakReference<Cell<Vid>> succ(curr->getBestNeighbor());
-            //Increment the reference count of the cell until
-            //the reference goes out of scope so that the cell is not recyled while we
-            //are using it
-            
-            Reference<Cell<Vid>> ref(succ.get()->getReference(succ.age));
+            child = succ.get();
             
             //The cell has  already been completed as it now has a different age than when  it had
-            //the target vertex
-            
-            if(!ref || ref->isComplete()) continue;
+            //the target vertex. Otherwise it cannot be reused for another vertex before our next
+            //quiescent point, so it is safe to work with it
             
-            child = ref.getPtr();
+            if(child->isComplete(succ.age)) continue;
         
             if(child->onStackOf(search)) //if on stack, update low link
                 curr->promote(child->index);
@@ -114,51 +126,70 @@ void Worker::execute(Search* const search){
 
 /**
  Pre: The cell must be owned by the thread
- Post: The cell's queue of neighboring cells is created. Each vertex that is a neighbor
- of the vertex represented by parameter cell will have a unique corresponding
- cell object after this call exists
+ Post: The cell's cursor points to the vertex's successors in the graph, or to the cell's own copy if
+ the graph decodes them (see Graph::transientSpans()). The successors are only resolved to cells when the
+ search gets to them, see getBestNeighbor()
  
  @param cell Pointer to the cell whose neighbors we are identifying
  */
 
 void Worker::initNeighbors(Cell<Vid>* cell){
     
-   // initNeighbors2(cell);
+    Vid degree;
+    const Vid* const succs = transientSpans ? graph.decodeNeighbors(cell->vertex, degree, cell->decodeBuffer())
+                                            : graph.getNeighborSpan(cell->vertex, degree);
+    
+    cell->setNeighbors(succs, succs + degree);
     
-    Vid age; Cell<Vid>* neighbor;
-    //get set of all the vertex's neighbors
-    const std::vector<Vid>& succs = graph.getNeighborsVector(cell->vertex);
+}
+
+//Returns the cell representing vertex, creating one if the vertex has not been seen yet
+inline WeakReference<Cell<Vid>> Worker::resolve(const Vid vertex){
+    
+    spareCell->vertex = vertex; //Set vertex
+    auto status = dict.put(vertex, WeakReference<Cell<Vid>>(spareCell,spareCell->getAge()));
+    
+    //We used up the cell object to store the neighbor so we need a new one
+    //for next time
+    if(status.second)
+        allocateSpareCell();
+    
+    return status.first;
+}
+
+/**
+ Pre: The cell must be owned by the thread's search
+ Post: best holds a neighbor of cell to be explored next. The function tries to choose a neighbor that
+ is not currently being explored by another search if one exists. Neighbors already complete are skipped,
+ since no search has to visit them again. In a run restricted to a subgraph, edges leaving it are skipped.
+ 
+ Successors are resolved off the cell's cursor. Those on another search's stack go into the cell's lookahead
+ window; once the window is full or the cursor is used up, we pick from the window instead. So an occupied
+ neighbor is only returned if none of the next few successors is free, and no neighbor is resolved more
+ than once however many times the cell is revisited
+ 
+ @return false if the cell has no neighbors left to visit
+ */
+
+bool Worker::getBestNeighbor(Cell<Vid>* const cell, WeakReference<Cell<Vid>>& best){
     
-    //create cell objects for the successors of vertex that have not yet been seen
-    for(auto& succ: succs){
+    while(cell->hasUnresolvedNeighbors() && !cell->windowFull()){
         
-        spareCell->vertex = succ; //Set vertex
-        auto status = dict.put(succ, WeakReference<Cell<Vid>>(spareCell,spareCell->age));
+        const Vid succ(cell->nextUnresolvedNeighbor());
         
-        //We used up the cell object to store the neighbor so we need a new one
-        //for next time
-        if(status.second)
-            allocateSpareCell();
+        if(filter && !filter->hasEdge(cell->vertex, succ)) continue; //The edge leaves the subgraph
         
-
-
-        neighbor = status.first.get();
-        age = status.first.age;
+        best = resolve(succ);
         
+        if(best.get()->isComplete(best.age)) continue;
         
-        if(!neighbor->isComplete(age)) //If the neighbor is complete, no search has to visit it again
-            cell->addNeighbor(neighbor, age);
+        if(Cell<Vid>::isUnclaimed(best) || best.get()->onStackOf(cell->status))
+            return true;
         
+        cell->deferNeighbor(best);
     }
     
-}
-
-void Worker::initNeighbors2(Cell<Vid>* cell){
-    
-    ShardedSpinLock<Vid, WeakReference<Cell<Vid>>>* map = dynamic_cast<ShardedSpinLock<Vid, WeakReference<Cell<Vid>>>*>(&dict);
-
-    map->putAll(graph.getNeighborsVector(cell->vertex), cell, *this);
-    
+    return cell->takeDeferredNeighbor(best);
 }
 
 
@@ -169,19 +200,19 @@ void Worker::buildSCC(Search* const search, Cell<Vid>* const head){
 
     TarjanStack* tarjanStack(search->getTS());
     
-    tarjanStack->back()->markComplete();
-    auto rit(tarjanStack->rbegin());
+    //Mark the cells from the top of the stack down to head complete
+    auto headPosition = tarjanStack->findFromTop([head](Cell<Vid>* const cell){
+        cell->markComplete();
+        return cell == head;
+    });
     
-    while(*rit != head)
-        (*(++rit))->markComplete();
+    tarjanStack->forEachFrom(headPosition, [&](Cell<Vid>* const cell){
+        scheduler.resumeAllBlockedOn(cell, S, ID);
+        retireCell(cell);
+        scc->push_back(cell->vertex);
+    });
     
-    for(auto it = (rit+1).base(); it != tarjanStack->end(); ++it){
-        scheduler.resumeAllBlockedOn(*it, S);
-        (*it)->permitRecycling();
-        scc->push_back((*it)->vertex);
-    }
-    
-    tarjanStack->erase((rit+1).base(), tarjanStack->end());
+    tarjanStack->truncate(headPosition);
     
     SCCs.push_back(scc);
 }
@@ -189,43 +220,69 @@ void Worker::buildSCC(Search* const search, Cell<Vid>* const head){
 void Worker::buildSingletonSCC(Search* const search, Cell<Vid>* const cell){
     search->tarjanStackPop();
     cell->markComplete();
-    scheduler.resumeAllBlockedOn(cell, S);
-    cell->permitRecycling();
+    scheduler.resumeAllBlockedOn(cell, S, ID);
+    retireCell(cell);
     SCCs.push_back(new SCC{cell->vertex});
     
 }
 
 void Worker::buildSoloSCC(Cell<Vid>* const cell){
     cell->markComplete();
-    scheduler.resumeAllBlockedOn(cell, S);
-    cell->permitRecycling();
+    scheduler.resumeAllBlockedOn(cell, S, ID);
+    retireCell(cell);
     SCCs.push_back(new SCC{cell->vertex});
 } 
 
+/*Pre: every worker thread has finished. Frees all the searches and cells allocated by this worker,
+  whether they were recycled, spare or still in use when the run was cancelled*/
 void Worker::cleanUp(){
-
-    delete spareCell; delete spareSearch;
     
-    for(Search* search: recycled)
+    for(Search* search: allocatedSearches)
         delete search;
     
-    for(Cell<Vid>*  cell: recycledCells)
+    for(Cell<Vid>*  cell: allocatedCells)
         delete cell;
+    
+    allocatedSearches.clear(); allocatedCells.clear();
+    recycled.clear(); recycledCells.clear(); retiredCells.clear();
         
 }
 
 void Worker::allocateSpareSearch(){
-    if(recycled.empty())
+    if(recycled.empty()){
         spareSearch = new Search;
+        allocatedSearches.push_back(spareSearch);
+    }
     else{
         spareSearch = recycled.back();
         recycled.pop_back();
     }
 }
 
+//Pre: the cell is complete and its blocked searches have been resumed
+void Worker::retireCell(Cell<Vid>* const cell){
+    cell->retire();
+    retiredCells.emplace_back(cell, epochs.current());
+}
+
+//Moves the retired cells whose grace period is over to recycledCells, advancing the epoch if possible
+void Worker::reclaimRetiredCells(){
+    const uint64_t now(epochs.tryAdvance());
+    
+    while(!retiredCells.empty() && EpochManager::gracePeriodOver(retiredCells.front().second, now)){
+        recycledCells.push_back(retiredCells.front().first);
+        retiredCells.pop_front();
+    }
+}
+
 void Worker::allocateSpareCell(){
-    if(recycledCells.empty())
+    if(recycledCells.empty() && !retiredCells.empty())
+        reclaimRetiredCells();
+    
+    if(recycledCells.empty()){
         spareCell = new Cell<Vid>;
+        allocatedCells.push_back(spareCell);
+    }
     else{
         spareCell = recycledCells.back();
         recycledCells.pop_back();
@@ -14,6 +14,9 @@
 #include "typedefs.h"
 #include "graph.h"
 #include "dictionary.h"
+#include "epochManager.hpp"
+#include "subgraphFilter.h"
+#include <deque>
 
 class MultiThreadedTarjan;
 
@@ -22,12 +25,14 @@ template <class V> class Cell;
 class Worker{
     
     friend class MultiThreadedTarjan;
+    friend class Microbenchmarks; //Frees the cells its workers hand out, as run() does
     
 private:
     
     //Variables
     MultiThreadedTarjan& scheduler;
     Dictionary<Vid, WeakReference<Cell<Vid>>>& dict;
+    const SubgraphFilter* const filter; //Null unless the run is restricted to a subgraph
     const unsigned int ID;
     const long MASK;
     std::vector<SCC*>  SCCs;
@@ -36,22 +41,48 @@ private:
     std::vector<Search*> recycled;
     std::vector<Cell<Vid>*> recycledCells;
     
+    //Cells this worker completed, with the epoch they were retired in. They move to recycledCells
+    //once their grace period is over. Retire epochs never decrease, so the oldest cell is at the front
+    EpochManager& epochs;
+    std::deque<std::pair<Cell<Vid>*, uint64_t>> retiredCells;
+    
+    //Every search and cell this worker allocated. A cancelled run can leave cells and searches
+    //anywhere (in the dictionary, suspended, on Pending), so memory is released through these lists
+    std::vector<Search*> allocatedSearches;
+    std::vector<Cell<Vid>*> allocatedCells;
+    
+    //NUMA node the worker runs on and the CPUs it is pinned to. No CPUs means the thread is not pinned
+    unsigned int node;
+    std::vector<int> cpus;
+    
+    //How often execute() checks whether the run was cancelled
+    const static int POLL_INTERVAL = 256;
+    int pollCountdown;
+    
+    const bool transientSpans; //The graph decodes successors, so cells keep their own copy, see initNeighbors()
+    
     
     //Methods
     void execute(Search* const  search);
     
     void initNeighbors(Cell<Vid>* cell);
+    
+    bool getBestNeighbor(Cell<Vid>* const cell, WeakReference<Cell<Vid>>& best);
+    
+    inline WeakReference<Cell<Vid>> resolve(const Vid vertex);
         
     void buildSCC(Search* const, Cell<Vid>* const);
     
     void buildSingletonSCC(Search* const search, Cell<Vid>* const cell);
     
+    void retireCell(Cell<Vid>* const cell);
+    
+    void reclaimRetiredCells();
+    
     void cleanUp();
     
     void allocateSpareSearch();
     
-    void initNeighbors2(Cell<Vid>* cell);
-    
     
     
 public:
@@ -59,7 +90,7 @@ public:
     const Graph<Vid>& graph;
 
     
-    Worker(unsigned int _ID, MultiThreadedTarjan& _algo, const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict);
+    Worker(unsigned int _ID, MultiThreadedTarjan& _algo, const Graph<Vid>& _graph, Dictionary<Vid, WeakReference<Cell<Vid>>>& _dict, EpochManager& _epochs, const SubgraphFilter* _filter = nullptr);
     void operator()();
     
     inline void cleanPaths(){
@@ -73,7 +104,12 @@ public:
     
     inline unsigned getID(){
         return ID;
-    }    
+    }
+    
+    inline unsigned int getNode(){
+        return node;
+    }
+    
     void allocateSpareCell();
     
     void buildSoloSCC(Cell<Vid>* const cell);
@@ -85,11 +121,8 @@ public:
    
     std::vector<Search*> S;
     std::vector<Cell<Vid>*> C;
-    std::vector<Vid> L;
-    std::vector<Vid> A;
-    
-    //Used in an optional method, not important
-    std::vector<bool> vAdded;
+    std::vector<Age> L;
+    std::vector<Age> A;
     
     
     